@@ -0,0 +1,15 @@
+
+    #ifndef ALGORAAPP_INFO_H
+    #define ALGORAAPP_INFO_H
+
+    namespace Algora {
+
+    struct AlgoraAppInfo {
+        static constexpr char GIT_REVISION[] = "7ed163a32ceafa12fa17a30904f3f451ff3260d7";
+        static constexpr char GIT_DATE[] = "2026-10-16T21:09:59+00:00";
+        static constexpr char GIT_TIMESTAMP[] = "1792184999";
+    };
+    }
+
+    #endif
+    
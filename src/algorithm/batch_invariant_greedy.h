@@ -37,11 +37,11 @@
 //
 // Edges for which the invariant may have been invalidated by an update are stored in a priority queue.
 // After all updates have been applied, the priority queue is processed as in `make_coloring_maximal_pq`.
-template<bool measure_color_ops = false>
-class InvariantGreedy : public DisjointMatchingAlgorithm<measure_color_ops, ArcMateExtension, FreeColorsExtension> {
+template<bool measure_color_ops = false, color_t fixed_colors = 0>
+class InvariantGreedy : public MateAndFreeColorsAlgorithm<measure_color_ops, fixed_colors> {
 
 private:
-    using algo_base = DisjointMatchingAlgorithm<measure_color_ops, ArcMateExtension, FreeColorsExtension>;
+    using algo_base = MateAndFreeColorsAlgorithm<measure_color_ops, fixed_colors>;
 
     using algo_base::diGraph;
     using algo_base::weights;
@@ -62,6 +62,14 @@ public:
         return name;
     }
 
+    // All arcs of the graph are new and uncolored, so all of them may violate the invariant
+    void bulk_init() override {
+        algo_base::bulk_init();
+        diGraph->mapArcs([this](Arc *arc) {
+            arcs_to_update.add(arc);
+        });
+    }
+
     void onPropertyChange(GraphArtifact *artifact,
                           const EdgeWeight &oldValue,
                           const EdgeWeight &newValue) override {
@@ -59,6 +59,14 @@ public:
         arcs_to_process.reset();
     }
 
+    // All arcs of the graph are new, so all of them are processed in the first batch
+    virtual void bulk_init() override {
+        algo_base::bulk_init();
+        diGraph->mapArcs([this](Arc *arc) {
+            arcs_to_process.add(arc);
+        });
+    }
+
     virtual void onPropertyChange(GraphArtifact *artifact,
                                   const EdgeWeight &/*oldValue*/,
                                   const EdgeWeight &newValue) override {
@@ -62,6 +62,15 @@ public:
         incidence_lists.resetAll();
     }
 
+    // All arcs of the graph are new, so all of their endpoints are processed in the first batch
+    virtual void bulk_init() override {
+        algo_base::bulk_init();
+        diGraph->mapArcs([this](Arc *arc) {
+            vertices_to_process.add(arc->getTail());
+            vertices_to_process.add(arc->getHead());
+        });
+    }
+
     virtual void onPropertyChange(GraphArtifact *artifact,
                                   const EdgeWeight &/*oldValue*/,
                                   const EdgeWeight &newValue) override {
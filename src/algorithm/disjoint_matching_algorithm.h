@@ -25,14 +25,21 @@
 
 #pragma once
 
+#include <cassert>
+#include <cstdint>
 #include <limits>
+#include <memory>
+#include <optional>
 #include <type_traits>
+#include <vector>
 
 #include "algorithm/dynamicweighteddigraphalgorithm.h"
 
 #include "datastructure/kcoloring.h"
 #include "datastructure/kcoloring_extensions.h"
+#include "datastructure/sorted_arcs.h"
 #include "algorithm/matching_defs.h"
+#include "tools/deadline.h"
 
 // Configuration for matching algorithms
 struct MatchingConfig {
@@ -40,17 +47,71 @@ struct MatchingConfig {
     unsigned b{1};
     bool sanitycheck{false};
     std::string graph_filename;
+    // Number of threads used to parse a text input file; 0 uses Algora's KonectNetworkReader
+    unsigned parse_threads{0};
+    // Read the input one delta at a time instead of loading the whole trace up front
+    bool stream_input{false};
+    // Renumber vertices at load time; `original_vertex_ids` then maps the new ids to the input ids,
+    // as it does for the dense ids of binary traces (empty: ids are those of the input)
+    VertexOrder vertex_order{VertexOrder::NONE};
+    std::vector<unsigned long long> original_vertex_ids;
+    // Process deltas incrementally starting at this delta (counting from 1) or the first delta
+    // at or after this timestamp; all earlier deltas are bulk-loaded as a single update
+    std::size_t start_delta{0};
+    std::optional<unsigned long long> start_timestamp;
+    // Collapse the updates of each arc within a delta into one, dropping those without net change
+    bool coalesce_updates{false};
+    // Group the updates into deltas spanning this many timestamp units or containing this many
+    // updates instead of one delta per timestamp (0: disabled)
+    unsigned long long window_span{0};
+    std::size_t window_updates{0};
+    // Interpret weights as demands that decay exponentially with this half-life, in timestamp units (0: disabled)
+    double decay_half_life{0};
+    // Read the next deltas on a background thread while the algorithms run
+    bool prefetch_deltas{false};
+    // Number of (b, algorithm) runs performed concurrently
+    unsigned threads{1};
+    // Replay the trace once per b, with all algorithms observing the same graph
+    bool single_pass{false};
+    // Replay the trace once for all b, with an instance of each algorithm per b observing the same graph,
+    // or a single one with the largest b if the algorithm computes nested solutions
+    bool shared_b{false};
+    // Perform each (b, algorithm) run in a child process of its own
+    bool isolate_runs{false};
+    // Build the graph as of the first delta once per replay before the algorithms observe it,
+    // which then take it over with `bulk_init` instead of through update callbacks
+    bool bulk_init{false};
+    // Time budget in seconds for running an algorithm after a delta (0: unlimited).
+    // Post-processing and recomputations from scratch stop once it is exhausted.
+    double delta_time_budget{0};
+    // Record the weight changes seen by the algorithms into this file (empty: disabled)
+    std::string capture_events_file;
+    // Write the arcs whose color changed per delta into this file (empty: disabled),
+    // which requires counting coloring operations
+    std::string diff_output_file;
 
     std::string outputFile = "";
     bool writeOutputfile{false};
+    // Write the results in the binary columnar format of `io/binary_results.h` instead of as CSV
+    bool binary_results{false};
 
     bool console_log{false};
 
+    // Replay each (b, algorithm) pair `warmup` times without reporting, then `repeat` times,
+    // reporting statistics over the latter
+    unsigned repeat{1};
+    unsigned warmup{0};
+
     // Whether or not to count the color, uncolor and recolor operations per delta
     bool count_coloring_ops{false};
 
     int seed{123};
     unsigned algorithm_order_seed{0};
+
+    // Id in the input file of the vertex with id `id` in the loaded trace
+    unsigned long long original_id(unsigned long long id) const {
+        return original_vertex_ids.empty() ? id : original_vertex_ids[id];
+    }
 };
 
 // Basuc update filtering
@@ -85,17 +146,59 @@ public:
 
     virtual void init() = 0;
 
+    // Like `init`, but the graph may already contain arcs, e.g., those of the first delta.
+    // The algorithm takes them over in a single pass, as if they had been inserted in one delta,
+    // instead of through individual update callbacks; `run` is called afterwards as for any delta.
+    virtual void bulk_init() = 0;
+
     // Returns the current solution weights
     virtual EdgeWeight deliver() = 0;
 
+    // Whether the first `b` matchings of the solution form the solution for `b`, for any `b` up to the number of
+    // matchings. A single instance with the largest b then computes the solutions for all b, see `set_nested_bs`.
+    virtual bool nests_solutions() const = 0;
+
+    // Report the solutions for each of `bs` instead of only the one for the number of matchings,
+    // if the algorithm nests its solutions; `bs` must not exceed the number of matchings.
+    virtual void set_nested_bs(const std::vector<int> &bs) = 0;
+
+    // The numbers of matchings set by `set_nested_bs`, empty if only the number of matchings is reported
+    virtual const std::vector<int>& get_nested_bs() const = 0;
+
+    // Returns the weight of the first `b` matchings of the current solution
+    virtual EdgeWeight deliver_nested(int b) = 0;
+
     // Can be called after `run` for sanity checks and similar purposes
     virtual void post_run() = 0;
 
     virtual const ColoringStatsExtension::color_op_counts& get_fine_counts() const = 0;
     virtual const ColoringStatsExtension::color_op_counts& get_coarse_counts() const = 0;
 
+    // Arcs whose color changed in the last delta, as of `post_run`.
+    // These are only tracked if coloring operations are counted and empty otherwise.
+    virtual const std::vector<ColoringStatsExtension::arc_change>& get_coloring_changes() const = 0;
+
     virtual void configure(std::shared_ptr<const MatchingConfig> matching_config) = 0;
 
+    // Hash of the current solution, used to check that repeated runs compute the same solution
+    virtual std::uint64_t solution_fingerprint() const = 0;
+
+    // Obtain the arcs sorted by weight from `sorted_arcs`, which is shared with other algorithms
+    // observing the same graph, instead of sorting them locally (`nullptr`).
+    virtual void set_sorted_arcs(SortedArcs *sorted_arcs) = 0;
+
+    // Map the ids of the vertices of the graph to their ids in the loaded trace via `trace_ids`, by vertex id,
+    // if the graph numbers its vertices on its own, see `StreamingWeightedDiGraph` (`nullptr` if they coincide).
+    virtual void set_trace_vertex_ids(const std::vector<unsigned long long> *trace_ids) = 0;
+
+    // Id in the input file of the vertex of the graph with id `id`
+    virtual unsigned long long original_id(unsigned long long id) const = 0;
+
+    // Id in the input file of `vertex`
+    unsigned long long original_id(const Vertex *vertex) const {
+        return original_id(vertex->getId());
+    }
+
     // Function to allow algorithms to output additional information to `stream`.
     // This should be used purely for writing data to `stream`.
     virtual void custom_output(std::ostream &stream) const = 0;
@@ -122,6 +225,11 @@ public:
         }
     }
 
+    // Algorithms that recompute their solution in `run` need nothing besides `init`.
+    virtual void bulk_init() override {
+        init();
+    }
+
     virtual void reset() {
         coloring.reset();
     }
@@ -130,6 +238,24 @@ public:
         return coloring.getTotalWeight();
     }
 
+    // Solutions are only nested by algorithms that prefer the first matchings, see `DynamicGreedy`.
+    virtual bool nests_solutions() const override {
+        return false;
+    }
+
+    virtual void set_nested_bs(const std::vector<int> &bs) override final {
+        assert(nests_solutions() || bs.empty());
+        nested_bs = bs;
+    }
+
+    virtual const std::vector<int>& get_nested_bs() const override final {
+        return nested_bs;
+    }
+
+    virtual EdgeWeight deliver_nested(int b) override final {
+        return coloring.getWeightOfFirstColors(b);
+    }
+
     virtual void post_run() final {
         if (matching_config->sanitycheck) {
             coloring.sanityCheck();
@@ -143,7 +269,10 @@ public:
     }
 
     virtual void onArcRemove(Arc* arc) override final {
-        weights->setValue(arc, 0);
+        // The weight may have been reset already, by the graph or by another algorithm observing it
+        if ((*weights)[arc] != 0) {
+            weights->setValue(arc, 0);
+        }
     }
 
     virtual const ColoringStatsExtension::color_op_counts& get_fine_counts() const final {
@@ -154,21 +283,66 @@ public:
         return coarse_counts;
     }
 
+    virtual const std::vector<ColoringStatsExtension::arc_change>& get_coloring_changes() const final {
+        if constexpr (measure_color_ops) {
+            return coloring.get_changes();
+        } else {
+            static const std::vector<ColoringStatsExtension::arc_change> no_changes;
+            return no_changes;
+        }
+    }
+
     virtual void configure(std::shared_ptr<const MatchingConfig> matching_config) override final {
         this->matching_config = matching_config;
     }
 
+    virtual std::uint64_t solution_fingerprint() const override final {
+        return coloring.fingerprint();
+    }
+
+    virtual void set_sorted_arcs(SortedArcs *sorted_arcs) override final {
+        this->sorted_arcs = sorted_arcs;
+    }
+
+    virtual void set_trace_vertex_ids(const std::vector<unsigned long long> *trace_ids) override final {
+        this->trace_ids = trace_ids;
+    }
+
+    using super::original_id;
+
+    virtual unsigned long long original_id(unsigned long long id) const override final {
+        return matching_config->original_id(trace_ids ? (*trace_ids)[id] : id);
+    }
+
     // The default implementation for `custom_output` is to do nothing.
     virtual void custom_output(std::ostream &/*stream*/) const override {}
 
 protected:
     std::shared_ptr<const MatchingConfig> matching_config;
 
+    // Deadline of the current call of `run`, see `MatchingConfig::delta_time_budget`
+    Deadline deadline;
+
+    void start_deadline() {
+        deadline.start(matching_config->delta_time_budget);
+    }
+
+    // The arcs of positive weight, sorted by non-increasing weight
+    std::vector<Arc*> arcs_by_weight() {
+        if (sorted_arcs != nullptr) {
+            return sorted_arcs->get();
+        }
+        std::vector<Arc*> arcs;
+        SortedArcs::sort(diGraph, weights, arcs);
+        return arcs;
+    }
+
     // Enable the `ColoringStatsExtension` only if `measure_color_ops` is true.
     // Otherwise, we only enable extensions given by the template parameters.
     // We only have the overhead from counting coloring operations if it is explicitly requested.
+    // It comes last, such that a `FixedColors` tag remains the first extension.
     using coloring_type = std::conditional_t<measure_color_ops,
-                                             KColoring<ColoringStatsExtension, ColoringExt...>,
+                                             KColoring<ColoringExt..., ColoringStatsExtension>,
                                              KColoring<ColoringExt...>>;
 
     coloring_type coloring{nullptr, nullptr, 1};
@@ -179,6 +353,10 @@ protected:
     ColoringStatsExtension::color_op_counts fine_counts, coarse_counts;
 
 private:
+    SortedArcs *sorted_arcs = nullptr;
+    const std::vector<unsigned long long> *trace_ids = nullptr;
+    std::vector<int> nested_bs;
+
     virtual void onDiGraphSet() override {
         super::onDiGraphSet();
         coloring.setGraph(diGraph);
@@ -199,3 +377,10 @@ private:
     }
 
 };
+
+// Algorithm whose coloring provides the mates and free colors of the vertices:
+// with `K` colors fixed at compile time, or with the `FreeColorsExtension` if `K == 0`.
+template<bool measure_color_ops, color_t K>
+using MateAndFreeColorsAlgorithm = std::conditional_t<K == 0,
+                                                      DisjointMatchingAlgorithm<measure_color_ops, FreeColorsExtension>,
+                                                      DisjointMatchingAlgorithm<measure_color_ops, FixedColors<K>>>;
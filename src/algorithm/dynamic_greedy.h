@@ -32,17 +32,18 @@
 #include "algorithm/disjoint_matching_algorithm.h"
 #include "datastructure/kcoloring_extensions.h"
 
-template<bool measure_color_ops = false, bool use_pp_ds = true, int randomized = 3>
-class DynamicGreedy : public DisjointMatchingAlgorithm<measure_color_ops, ArcMateExtension, FreeColorsExtension> {
+template<bool measure_color_ops = false, bool use_pp_ds = true, int randomized = 3, color_t fixed_colors = 0>
+class DynamicGreedy : public MateAndFreeColorsAlgorithm<measure_color_ops, fixed_colors> {
 
 public:
     static constexpr int num_random_reps = randomized;
 
-    using algo_base = DisjointMatchingAlgorithm<measure_color_ops, ArcMateExtension, FreeColorsExtension>;
+    using algo_base = MateAndFreeColorsAlgorithm<measure_color_ops, fixed_colors>;
 
     using algo_base::diGraph;
     using algo_base::weights;
     using algo_base::coloring;
+    using algo_base::deadline;
 
 public:
     DynamicGreedy(int recursion_depth = 1,
@@ -69,6 +70,9 @@ public:
         if (update_filter.getUpThreshold() != 1) {
             name += "-ft" + to_string_with_precision(update_filter.getUpThreshold(), 2);
         }
+        if (nests_solutions()) {
+            name += "-nested";
+        }
         return name;
     }
 
@@ -87,13 +91,40 @@ public:
         if (update_filter.getUpThreshold() != 1) {
             name += "-ft" + to_string_with_precision(update_filter.getUpThreshold(), 2);
         }
+        if (nests_solutions()) {
+            name += "-n";
+        }
         return name;
     }
 
+    // With a shared replay for several b, the solutions are nested: arcs are placed into the first matching
+    // where they fit or are heavier than the adjacent arcs, and arcs move into earlier matchings that become free.
+    // The solution for the largest b then contains those for all smaller b, and a candidate search or
+    // post-processing serves all of them at once.
+    // The randomized variants pick the matching to replace arcs in at random, so they do not nest their solutions.
+    virtual bool nests_solutions() const override {
+        return randomized == 0 && algo_base::matching_config != nullptr && algo_base::matching_config->shared_b
+                && algo_base::matching_config->all_bs.size() > 1;
+    }
+
+    // Insert the arcs of the graph by non-increasing weight instead of in the order of the trace.
+    // Each arc is handled exactly like an update from weight 0, i.e., subject to `update_filter`.
+    virtual void bulk_init() override {
+        algo_base::bulk_init();
+        for (auto arc: algo_base::arcs_by_weight()) {
+            onPropertyChange(arc, 0, (*weights)[arc]);
+        }
+    }
+
     virtual void onPropertyChange(GraphArtifact *artifact,
                                   const EdgeWeight &oldValue,
                                   const EdgeWeight &newValue) override {
         auto arc = static_cast<Arc*>(artifact);
+        if constexpr (use_pp_ds) {
+            if (newValue == 0) {
+                post_processor.discard_arc(arc);
+            }
+        }
         if (update_filter.test(oldValue, newValue)) {
             if constexpr (use_pp_ds) {
                 if (oldValue > newValue && coloring.is_colored(arc)) {
@@ -120,11 +151,12 @@ public:
     }
 
     virtual void run() override {
+        algo_base::start_deadline();
         if (post_process) {
             if constexpr (use_pp_ds) {
-                post_processor.perform_post_processing(coloring, weights);
+                post_processor.perform_post_processing(coloring, weights, &deadline);
             } else {
-                make_coloring_maximal_pq(coloring, diGraph, weights);
+                make_coloring_maximal_pq(coloring, diGraph, weights, &deadline);
             }
         }
     }
@@ -218,10 +250,47 @@ private:
 
         // Assert that deleted arcs are uncolored.
         assert(!is_deletion || !coloring.is_colored(arc));
+
+        if (nests_solutions()) {
+            for (auto vertex: {arc->getTail(), arc->getHead()}) {
+                promote_into(arc_color, vertex);
+            }
+        }
+    }
+
+    // If `color` is free at `vertex`, move the heaviest arc of a later matching at `vertex` into the matching
+    // `color`, provided it is free at the other end as well. This keeps heavy arcs in the first matchings,
+    // which form the solutions for smaller b, see `nests_solutions`.
+    void promote_into(color_t color, Vertex *vertex) {
+        if (!coloring.is_color_free(vertex, color)) {
+            return;
+        }
+        Arc *heaviest = nullptr;
+        for (color_t later = color + 1; later < coloring.getNumColors(); ++later) {
+            auto a = coloring.getArcToMate(later, vertex);
+            if (a != nullptr && coloring.is_color_free(a->getOther(vertex), color) &&
+                    (heaviest == nullptr || (*weights)[a] > (*weights)[heaviest])) {
+                heaviest = a;
+            }
+        }
+        if (heaviest == nullptr) {
+            return;
+        }
+        coloring.uncolor(heaviest);
+        coloring.color(heaviest, color);
+        if constexpr (use_pp_ds) {
+            // Uncolored arcs at its ends may fit into the matching it left
+            for (auto v: {heaviest->getTail(), heaviest->getHead()}) {
+                diGraph->mapIncidentArcs(v, [this](Arc* a) {
+                    post_processor.register_arc(a);
+                });
+            }
+        }
     }
 
     virtual void reset() override {
         algo_base::reset();
+        post_processor.reset();
         rng_engine.seed(algo_base::matching_config->seed);
     }
 
@@ -346,6 +415,9 @@ private:
     }
 
     std::pair<AdjacentArcWeightPair, color_t> pick_pair_to_replace(Arc *arc) {
+        if (nests_solutions()) {
+            return pick_first_lighter_pair(arc);
+        }
         if constexpr (randomized > 0) {
             return pick_lightest_of_random_colors(num_random_reps, arc);
         } else {
@@ -385,6 +457,28 @@ private:
         return {result, min_color};
     }
 
+    // The adjacent arcs of the first color in which they weigh less than `arc`, which improves the solutions
+    // for the most numbers of matchings when replaced. If there is no such color, the weight is maximal.
+    std::pair<AdjacentArcWeightPair, color_t> pick_first_lighter_pair(Arc *arc) {
+        auto color = coloring.first_color_lighter_than(arc, (*weights)[arc]);
+        if (color == UNCOLORED) {
+            return {{nullptr, nullptr, std::numeric_limits<EdgeWeight>::max()}, UNCOLORED};
+        }
+        AdjacentArcWeightPair result{coloring.getArcToMate(color, arc->getTail()),
+                                     coloring.getArcToMate(color, arc->getHead()),
+                                     0};
+        // An antiparallel arc is the mate at both ends
+        if (result.head_arc == result.tail_arc) {
+            result.head_arc = nullptr;
+        }
+        for (auto a: {result.tail_arc, result.head_arc}) {
+            if (a != nullptr) {
+                result.weight += (*weights)[a];
+            }
+        }
+        return {result, color};
+    }
+
     void register_neighbors_for_post_processing(Arc *arc) {
         if constexpr (use_pp_ds) {
             if (!coloring.is_colored(arc)) {
@@ -36,13 +36,14 @@
 
 #include "tools/utility.h"
 
-template<bool common_color, bool rotate_long, bool measure_color_ops = false, bool use_pp_ds = false, bool randomized = false>
-class DynGreedyKEdgeColoringHybrid : public DisjointMatchingAlgorithm<measure_color_ops, ArcMateExtension, FreeColorsExtension> {
-    using algo_base = DisjointMatchingAlgorithm<measure_color_ops, ArcMateExtension, FreeColorsExtension>;
+template<bool common_color, bool rotate_long, bool measure_color_ops = false, bool use_pp_ds = false, bool randomized = false, color_t fixed_colors = 0>
+class DynGreedyKEdgeColoringHybrid : public MateAndFreeColorsAlgorithm<measure_color_ops, fixed_colors> {
+    using algo_base = MateAndFreeColorsAlgorithm<measure_color_ops, fixed_colors>;
 
     using algo_base::diGraph;
     using algo_base::weights;
     using algo_base::coloring;
+    using algo_base::deadline;
 
 public:
     DynGreedyKEdgeColoringHybrid(bool post_process = false,
@@ -97,12 +98,33 @@ public:
         compute_from_scratch = false;
         update_count = 0;
         delta_over = false;
+        post_processor.reset();
         rng_engine.seed(algo_base::matching_config->seed);
     }
 
+    // Color the arcs of the graph from scratch instead of inserting them one by one
+    virtual void bulk_init() override {
+        algo_base::bulk_init();
+        algo_base::start_deadline();
+        compute_edge_coloring();
+        update_count = diGraph->getNumArcs(false);
+        if constexpr (use_pp_ds) {
+            diGraph->mapArcs([this](Arc *arc) {
+                if (!coloring.is_colored(arc)) {
+                    post_processor.register_arc(arc);
+                }
+            });
+        }
+    }
+
     virtual void onPropertyChange(GraphArtifact *artifact,
                                   const EdgeWeight &oldValue,
                                   const EdgeWeight &newValue) override {
+        if constexpr (use_pp_ds) {
+            if (newValue == 0) {
+                post_processor.discard_arc(static_cast<Arc*>(artifact));
+            }
+        }
         if (update_filter.test(oldValue, newValue)) {
             if constexpr (use_pp_ds) {
                 auto arc = static_cast<Arc*>(artifact);
@@ -151,6 +173,7 @@ public:
     }
 
     virtual void run() override {
+        algo_base::start_deadline();
         delta_over = true;
         if (compute_from_scratch) {
             algo_base::reset();
@@ -161,9 +184,9 @@ public:
                 //make_coloring_maximal_pq(coloring, diGraph, weights);
             } else {
                 if constexpr (use_pp_ds) {
-                    post_processor.perform_post_processing(coloring, weights);
+                    post_processor.perform_post_processing(coloring, weights, &deadline);
                 } else {
-                    make_coloring_maximal_pq(coloring, diGraph, weights);
+                    make_coloring_maximal_pq(coloring, diGraph, weights, &deadline);
                 }
             }
         }
@@ -321,23 +344,23 @@ private:
         return std::max(c, d);
     }
 
-    // Compute an edge-coloring from scratch
+    // Compute an edge-coloring from scratch, heaviest arcs first, until the deadline expires.
+    // With the post-processing data structure, the remaining arcs are left to the post-processing.
     void compute_edge_coloring() {
         color_t colors = 0;
 
-        std::vector<Arc*> edges;
-        edges.reserve(diGraph->getNumArcs(false));
-        diGraph->mapArcs([this,&edges](Arc *arc) {
-            if ((*weights)[arc] > 0) {
-                edges.push_back(arc);
-            }
-        });
-
-        std::sort(edges.begin(), edges.end(), [this](const Arc* lop, const Arc* rop) {
-            return (*weights)[lop] > (*weights)[rop];
-        });
+        auto edges = algo_base::arcs_by_weight();
 
-        for (auto arc: edges) {
+        for (auto it = edges.begin(); it != edges.end(); ++it) {
+            auto arc = *it;
+            if (deadline.expired()) {
+                if constexpr (use_pp_ds) {
+                    for (; it != edges.end(); ++it) {
+                        post_processor.carry_arc(*it);
+                    }
+                }
+                break;
+            }
             if (coloring.any_color_free(arc->getTail()) &&
                     coloring.any_color_free(arc->getHead())) {
                 auto c = color_edge(arc, arc->getTail());
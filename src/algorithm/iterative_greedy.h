@@ -60,17 +60,7 @@ public:
 
     virtual void run() override {
         algo_base::reset();
-        std::vector<Arc*> arcs_sorted;
-        arcs_sorted.reserve(diGraph->getNumArcs(false));
-        diGraph->mapArcs([this, &arcs_sorted](Arc *arc) {
-            if ((*weights)[arc] > 0) {
-                arcs_sorted.push_back(arc);
-            }
-        });
-
-        std::sort(arcs_sorted.begin(), arcs_sorted.end(), [this](const Arc *lop, const Arc *rop) {
-            return (*weights)[lop] > (*weights)[rop];
-        });
+        auto arcs_sorted = algo_base::arcs_by_weight();
 
         auto num_colors = coloring.getNumColors();
         std::vector<Arc*> remaining_arcs;
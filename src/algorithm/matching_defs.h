@@ -30,6 +30,10 @@
 enum AggregateType {SUM,MAX,AVG,MEDIAN,B_SUM};
 const std::string aggregate_names[] = {"SUM", "MAX", "AVG", "MEDIAN", "B_SUM"};
 
+// Order in which vertices are renumbered at load time, see `compact_vertex_ids`.
+enum class VertexOrder {NONE, FIRST_APPEARANCE, DEGREE, RCM};
+const std::string vertex_order_names[] = {"none", "first", "degree", "rcm"};
+
 typedef unsigned long int EdgeWeight;
 // User-defined integer literal for the `EdgeWeight` type.
 inline constexpr EdgeWeight operator""_ew(unsigned long long value) {
@@ -0,0 +1,103 @@
+/**
+ * Copyright (C) 2022-2023 : Kathrin Hanauer, Lara Ost
+ *
+ * This file is part of DyDJ Match.
+ *
+ * DyDJ Match is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DyDJ Match is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DyDJ Match.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact information:
+ *   https://github.com/DJ-Match/DyDJ-Match
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "extern/argtable3-3.0.3/argtable3.h"
+
+#include "io/binary_trace.h"
+#include "io/trace_loader.h"
+#include "tools/chronotimer.h"
+
+// Converts a Konect edge list into the binary trace format read by DyDjMatch.
+int main(int argc, char **argv) {
+    const char *progname = argv[0];
+
+    struct arg_lit *help = arg_lit0(NULL, "help", "Print help.");
+    struct arg_str *input = arg_strn(NULL, NULL, "INPUT", 1, 1, "Path to the Konect edge list to convert (optionally .gz/.zst).");
+    struct arg_str *output = arg_strn(NULL, NULL, "OUTPUT", 1, 1, "Path of the binary trace to write.");
+    struct arg_int *parse_threads = arg_int0(NULL, "parse-threads", NULL, "parse the input with this many threads");
+    struct arg_end *end = arg_end(100);
+
+    void *argtable[] = {
+            help,
+            input,
+            output,
+            parse_threads,
+            end
+    };
+
+    int nerrors = arg_parse(argc, argv, argtable);
+
+    if (help->count > 0) {
+        printf("Usage: %s", progname);
+        arg_print_syntax(stdout, argtable, "\n");
+        arg_print_glossary(stdout, argtable,"  %-40s %s\n");
+        arg_freetable(argtable, sizeof(argtable) / sizeof(argtable[0]));
+        return 0;
+    }
+
+    if (nerrors > 0) {
+        arg_print_errors(stderr, end, progname);
+        printf("Try '%s --help' for more information.\n",progname);
+        arg_freetable(argtable, sizeof(argtable) / sizeof(argtable[0]));
+        return 1;
+    }
+
+    std::string input_filename = input->sval[0];
+    std::string output_filename = output->sval[0];
+    int num_threads = parse_threads->count > 0 ? parse_threads->ival[0] : 0;
+    arg_freetable(argtable, sizeof(argtable) / sizeof(argtable[0]));
+
+    ChronoTimer timer;
+    std::vector<TraceUpdate> updates;
+    std::vector<TraceUpdate::vertex_id> original_ids;
+    double decompression_seconds;
+    if (!load_trace(input_filename, num_threads, updates, original_ids, decompression_seconds)) {
+        std::cout << "Error! Could not read file " << input_filename << "\n";
+        return 1;
+    }
+    std::cout << "Input I/O took " << timer.elapsed() << "s\n";
+    if (compression_of(input_filename) != Compression::NONE) {
+        std::cout << "Decompression took " << decompression_seconds << "s\n";
+    }
+
+    timer.restart();
+    std::ofstream output_file(output_filename, std::ios::binary | std::ios::trunc);
+    if (!output_file.is_open()) {
+        std::cout << "Error! Could not open file " << output_filename << "\n";
+        return 1;
+    }
+    if (!BinaryTraceWriter().write(output_file, updates)) {
+        std::cout << "Error! Could not write file " << output_filename << "\n";
+        return 1;
+    }
+    output_file.close();
+    std::cout << "Output I/O took " << timer.elapsed() << "s\n";
+    std::cout << "Converted " << updates.size() << " updates\n";
+
+    return 0;
+}
@@ -0,0 +1,236 @@
+/**
+ * Copyright (C) 2022-2023 : Kathrin Hanauer, Lara Ost
+ *
+ * This file is part of DyDJ Match.
+ *
+ * DyDJ Match is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DyDJ Match is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DyDJ Match.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact information:
+ *   https://github.com/DJ-Match/DyDJ-Match
+ *
+ * Author:
+ *   Lara Ost
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "graph/arc.h"
+#include "graph/vertex.h"
+#include "property/fastpropertymap.h"
+#include "property/modifiableproperty.h"
+
+#include "algorithm/matching_defs.h"
+#include "tools/weight_scan.h"
+
+using namespace Algora;
+
+/*
+ * Storage of a `BasicKColoring` with `K` colors fixed at compile time.
+ * All data of a vertex, i.e., its arc to the mate of each color, their weights and the set of its free colors,
+ * is kept in a single cache-line aligned record, and arc colors are stored in 8 bits.
+ * Mates are not stored separately, but derived from the arcs to them.
+ * Provides the arcs to the mates like `DynamicColorStorage` and the interface of `FreeColorsExtension`,
+ * with the same results.
+ */
+template<color_t K>
+class FixedColorStorage {
+    static_assert(K > 0 && K <= 64, "FixedColorStorage supports 1 to 64 colors");
+
+public:
+    // Number of colors fixed at compile time, 0 if it is set at runtime
+    static constexpr color_t fixed_colors = K;
+
+    std::pair<AdjacentArcWeightPair, color_t> lightest_adjacent_colored_arcs(const Arc *arc, ModifiableProperty<EdgeWeight> *weights) const {
+        const auto &tail_record = record(arc->getTail());
+        const auto &head_record = record(arc->getHead());
+        auto return_value = AdjacentArcWeightPair{nullptr, nullptr, std::numeric_limits<EdgeWeight>::max()};
+        color_t min_color = UNCOLORED;
+        for (color_t col = 0; col < K; ++col) {
+            auto tail_arc = tail_record.mate_arcs[col];
+            auto head_arc = head_record.mate_arcs[col];
+            EdgeWeight weight = 0;
+            for (auto a: {tail_arc, head_arc}) {
+                if (a != nullptr) {
+                    weight += (*weights)[a];
+                }
+            }
+            if (weight < return_value.weight) {
+                return_value = {tail_arc, head_arc, weight};
+                min_color = col;
+            }
+        }
+        return {return_value, min_color};
+    }
+
+    // The first color whose arcs adjacent to `arc` weigh less than `weight` in total, or `UNCOLORED`
+    color_t first_color_lighter_than(const Arc *arc, EdgeWeight weight) const {
+        const auto &tail_record = record(arc->getTail());
+        const auto &head_record = record(arc->getHead());
+        return first_lighter_color(tail_record.mate_weights, head_record.mate_weights,
+                                   tail_record.mate_arcs, head_record.mate_arcs, K, weight);
+    }
+
+    Arc* getArcToMate(color_t col, Vertex* vertex) const {
+        return record(vertex).mate_arcs[col];
+    }
+
+    std::vector<Arc*> getColoredArcs(Vertex* vertex) const {
+        const auto &r = record(vertex);
+        std::vector<Arc*> colored_arcs;
+        colored_arcs.reserve(K);
+        for (auto a: r.mate_arcs) {
+            if (a != nullptr) {
+                colored_arcs.push_back(a);
+            }
+        }
+        return colored_arcs;
+    }
+
+    Arc* getLightestColoredEdge(Vertex* vertex, ModifiableProperty<EdgeWeight> *weights) {
+        const auto &r = record(vertex);
+        Arc *lightest = nullptr;
+        EdgeWeight min_weight = std::numeric_limits<EdgeWeight>::max();
+        for (auto a: r.mate_arcs) {
+            if (a != nullptr && (*weights)[a] < min_weight) {
+                lightest = a;
+                min_weight = (*weights)[a];
+            }
+        }
+        return lightest;
+    }
+
+    color_t get_any_free_color(Vertex* v) const {
+        return lowest_color(record(v).free_colors);
+    }
+
+    color_t common_free_color(Vertex* v1, Vertex* v2) const {
+        return lowest_color(record(v1).free_colors & record(v2).free_colors);
+    }
+
+    bool any_color_free(Vertex* v1) const {
+        return record(v1).free_colors != 0;
+    }
+    bool all_colors_free(Vertex* v1) const {
+        return record(v1).free_colors == all_colors;
+    }
+    bool no_color_free(Vertex* v1) const {
+        return record(v1).free_colors == 0;
+    }
+
+protected:
+    color_t stored_color(const Arc *arc) const {
+        auto color = arc_colors[arc];
+        return color == uncolored ? UNCOLORED : color;
+    }
+
+    void store_color(const Arc *arc, color_t color) {
+        arc_colors.setValue(arc, color == UNCOLORED ? uncolored : static_cast<std::uint8_t>(color));
+    }
+
+    bool has_mate(color_t color, const Vertex *vertex) const {
+        return record(vertex).mate_arcs[color] != nullptr;
+    }
+
+    void store_mates(Arc *arc, color_t color, EdgeWeight weight) {
+        for (auto v: {arc->getTail(), arc->getHead()}) {
+            auto &r = record(v);
+            assert(r.mate_arcs[color] == nullptr);
+            r.mate_arcs[color] = arc;
+            r.mate_weights[color] = weight;
+            r.free_colors &= ~bit(color);
+        }
+    }
+
+    void clear_mates(Arc *arc, color_t color) {
+        for (auto v: {arc->getTail(), arc->getHead()}) {
+            auto &r = record(v);
+            assert(r.mate_arcs[color] != nullptr);
+            r.mate_arcs[color] = nullptr;
+            r.mate_weights[color] = 0;
+            r.free_colors |= bit(color);
+        }
+    }
+
+    void set_mate_weight(Arc *arc, color_t color, EdgeWeight weight) {
+        for (auto v: {arc->getTail(), arc->getHead()}) {
+            record(v).mate_weights[color] = weight;
+        }
+    }
+
+    void reset_storage(color_t /*num_colors*/) {
+        records.clear();
+        arc_colors.setDefaultValue(uncolored);
+        arc_colors.resetAll();
+    }
+
+    void set_num_colors_storage(color_t num_colors) {
+        assert(num_colors == K);
+        (void) num_colors;
+    }
+
+private:
+    // Smallest unsigned integer type with at least `K` bits
+    using mask_type = std::conditional_t<(K <= 8), std::uint8_t,
+                      std::conditional_t<(K <= 16), std::uint16_t,
+                      std::conditional_t<(K <= 32), std::uint32_t, std::uint64_t>>>;
+
+    static constexpr mask_type all_colors = static_cast<mask_type>(~std::uint64_t{0} >> (64 - K));
+
+    static constexpr std::uint8_t uncolored = std::numeric_limits<std::uint8_t>::max();
+
+    struct alignas(64) vertex_record {
+        // Arc to the mate of each color, or `nullptr`
+        Arc *mate_arcs[K] = {};
+        // Weight of the arc to the mate of each color, or 0
+        EdgeWeight mate_weights[K] = {};
+        // Colors not used by any incident arc
+        mask_type free_colors = all_colors;
+    };
+
+    static constexpr vertex_record empty_record{};
+
+    static mask_type bit(color_t color) {
+        return static_cast<mask_type>(mask_type{1} << color);
+    }
+
+    static color_t lowest_color(mask_type mask) {
+        return mask == 0 ? UNCOLORED : __builtin_ctzll(mask);
+    }
+
+    const vertex_record& record(const Vertex *vertex) const {
+        auto id = vertex->getId();
+        return id < records.size() ? records[id] : empty_record;
+    }
+
+    vertex_record& record(const Vertex *vertex) {
+        auto id = vertex->getId();
+        if (id >= records.size()) {
+            records.resize(id + 1);
+        }
+        return records[id];
+    }
+
+    // Records by vertex id, grown on demand
+    std::vector<vertex_record> records;
+
+    // Colors of the arcs, `uncolored` for uncolored arcs
+    FastPropertyMap<std::uint8_t> arc_colors{uncolored};
+};
@@ -25,9 +25,14 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <functional>
+#include <limits>
+#include <numeric>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include "boost/range/irange.hpp"
@@ -38,29 +43,192 @@
 #include "property/modifiableproperty.h"
 
 #include "algorithm/matching_defs.h"
+#include "datastructure/fixed_color_storage.h"
 #include "tools/color_set.h"
+#include "tools/weight_scan.h"
 
 using namespace Algora;
 
+// Colors of the arcs and mates of the vertices of a `BasicKColoring` whose number of colors is set at runtime.
+// The arcs to the mates and their weights are stored vertex-major, such that the colored arcs of a vertex
+// are contiguous.
+class DynamicColorStorage {
+
+public:
+    // Number of colors fixed at compile time, 0 if it is set at runtime
+    static constexpr color_t fixed_colors = 0;
+
+    // The pair of arcs of the same color adjacent to `arc` with the lowest total weight, and that color
+    std::pair<AdjacentArcWeightPair, color_t> lightest_adjacent_colored_arcs(const Arc *arc, ModifiableProperty<EdgeWeight> *weights) const {
+        auto tail_arcs = mate_arcs_of(arc->getTail());
+        auto head_arcs = mate_arcs_of(arc->getHead());
+        auto return_value = AdjacentArcWeightPair{nullptr, nullptr, std::numeric_limits<EdgeWeight>::max()};
+        color_t min_color = UNCOLORED;
+        for (color_t col = 0; col < num_slots; ++col) {
+            auto tail_arc = tail_arcs[col];
+            auto head_arc = head_arcs[col];
+            EdgeWeight weight = 0;
+            for (auto a: {tail_arc, head_arc}) {
+                if (a != nullptr) {
+                    weight += (*weights)[a];
+                }
+            }
+            if (weight < return_value.weight) {
+                return_value = {tail_arc, head_arc, weight};
+                min_color = col;
+            }
+        }
+        return {return_value, min_color};
+    }
+
+    // The first color whose arcs adjacent to `arc` weigh less than `weight` in total, or `UNCOLORED`
+    color_t first_color_lighter_than(const Arc *arc, EdgeWeight weight) const {
+        return first_lighter_color(mate_weights_of(arc->getTail()), mate_weights_of(arc->getHead()),
+                                   mate_arcs_of(arc->getTail()), mate_arcs_of(arc->getHead()),
+                                   num_slots, weight);
+    }
+
+    Arc* getArcToMate(color_t col, Vertex* vertex) const {
+        return mate_arcs_of(vertex)[col];
+    }
+
+    std::vector<Arc*> getColoredArcs(Vertex* vertex) const {
+        auto arcs = mate_arcs_of(vertex);
+        std::vector<Arc*> colored_arcs;
+        colored_arcs.reserve(num_slots);
+        for (color_t col = 0; col < num_slots; ++col) {
+            if (arcs[col] != nullptr) {
+                colored_arcs.push_back(arcs[col]);
+            }
+        }
+        return colored_arcs;
+    }
+
+    Arc* getLightestColoredEdge(Vertex* vertex, ModifiableProperty<EdgeWeight> *weights) {
+        auto arcs = mate_arcs_of(vertex);
+        Arc *lightest = nullptr;
+        EdgeWeight min_weight = std::numeric_limits<EdgeWeight>::max();
+        for (color_t col = 0; col < num_slots; ++col) {
+            if (arcs[col] != nullptr && (*weights)[arcs[col]] < min_weight) {
+                lightest = arcs[col];
+                min_weight = (*weights)[arcs[col]];
+            }
+        }
+        return lightest;
+    }
+
+protected:
+    color_t stored_color(const Arc *arc) const {
+        return arc_colors[arc];
+    }
+
+    void store_color(const Arc *arc, color_t color) {
+        arc_colors.setValue(arc, color);
+    }
+
+    bool has_mate(color_t color, const Vertex *vertex) const {
+        return mate_arcs_of(vertex)[color] != nullptr;
+    }
+
+    void store_mates(Arc *arc, color_t color, EdgeWeight weight) {
+        for (auto v: {arc->getTail(), arc->getHead()}) {
+            auto offset = slot_offset(v);
+            assert(mate_arcs[offset + color] == nullptr);
+            mate_arcs[offset + color] = arc;
+            mate_weights[offset + color] = weight;
+        }
+    }
+
+    void clear_mates(Arc *arc, color_t color) {
+        for (auto v: {arc->getTail(), arc->getHead()}) {
+            auto offset = slot_offset(v);
+            assert(mate_arcs[offset + color] != nullptr);
+            mate_arcs[offset + color] = nullptr;
+            mate_weights[offset + color] = 0;
+        }
+    }
+
+    void set_mate_weight(Arc *arc, color_t color, EdgeWeight weight) {
+        for (auto v: {arc->getTail(), arc->getHead()}) {
+            mate_weights[slot_offset(v) + color] = weight;
+        }
+    }
+
+    void reset_storage(color_t num_colors) {
+        arc_colors.setDefaultValue(UNCOLORED);
+        arc_colors.resetAll();
+        num_slots = num_colors;
+        mate_arcs.clear();
+        mate_weights.clear();
+        no_mate_arcs.assign(num_colors, nullptr);
+        no_mate_weights.assign(num_colors, 0);
+    }
+
+    void set_num_colors_storage(color_t /*num_colors*/) {}
+
+private:
+    // Arcs to the mates of `vertex`, indexed by color
+    Arc* const* mate_arcs_of(const Vertex *vertex) const {
+        std::size_t offset = vertex->getId() * num_slots;
+        return offset < mate_arcs.size() ? mate_arcs.data() + offset : no_mate_arcs.data();
+    }
+
+    // Weights of the arcs to the mates of `vertex`, indexed by color
+    const EdgeWeight* mate_weights_of(const Vertex *vertex) const {
+        std::size_t offset = vertex->getId() * num_slots;
+        return offset < mate_weights.size() ? mate_weights.data() + offset : no_mate_weights.data();
+    }
+
+    // Offset of the slots of `vertex` in `mate_arcs` and `mate_weights`, which are grown to include them
+    std::size_t slot_offset(const Vertex *vertex) {
+        std::size_t offset = vertex->getId() * num_slots;
+        if (offset >= mate_arcs.size()) {
+            mate_arcs.resize(offset + num_slots, nullptr);
+            mate_weights.resize(offset + num_slots, 0);
+        }
+        return offset;
+    }
+
+    // Map from edges to colors.
+    // Values are either in `[0,num_colors-1]`, or `UNCOLORED`
+    FastPropertyMap<color_t> arc_colors{UNCOLORED};
+
+    // Number of colors, i.e., of slots per vertex in `mate_arcs`
+    color_t num_slots = 0;
+
+    // Arc to the mate of each vertex for each color, or `nullptr`, at `vertex id * num_slots + color`
+    std::vector<Arc*> mate_arcs;
+
+    // Weight of the arc in the same slot of `mate_arcs`, or 0
+    std::vector<EdgeWeight> mate_weights;
+
+    // `num_slots` times `nullptr` and 0, respectively, for vertices beyond `mate_arcs`
+    std::vector<Arc*> no_mate_arcs;
+    std::vector<EdgeWeight> no_mate_weights;
+};
+
 /*
  * A datastructure to store incomplete edge-colorings with `k` colors.
+ * `Storage` holds the colors of the arcs and the mates of the vertices, see `DynamicColorStorage`
+ * and `FixedColorStorage`; use `KColoring` to select it.
  */
-template<typename... Ext>
-class KColoring : public Ext... {
+template<typename Storage, typename... Ext>
+class BasicKColoring : public Storage, public Ext... {
 
 public:
     // Number of extensions
     static constexpr auto num_ext = std::tuple_size_v<std::tuple<Ext...>>;
 
 public:
-    KColoring(DiGraph *graph,
-              ModifiableProperty<EdgeWeight> *weights,
-              color_t num_colors) : graph(graph),
-                                    weights(weights),
-                                    num_colors(num_colors),
-                                    mates_by_color(num_colors, {nullptr}) {
+    BasicKColoring(DiGraph *graph,
+                   ModifiableProperty<EdgeWeight> *weights,
+                   color_t num_colors) : graph(graph),
+                                         weights(weights),
+                                         num_colors(num_colors) {
+        Storage::reset_storage(num_colors);
+        color_weights.assign(getNumColors(), 0);
         if (weights != nullptr) {
-            weights->onPropertyChange(this, std::bind(&KColoring::onEdgeWeightChange,
+            weights->onPropertyChange(this, std::bind(&BasicKColoring::onEdgeWeightChange,
                                                     this,
                                                     std::placeholders::_1,
                                                     std::placeholders::_2,
@@ -69,14 +237,9 @@ public:
     }
 
     void reset() {
-        arc_colors.setDefaultValue(UNCOLORED);
-        arc_colors.resetAll();
-        mates_by_color.resize(num_colors);
-        for(auto &map: mates_by_color) {
-            map.setDefaultValue(nullptr);
-            map.resetAll();
-        }
+        Storage::reset_storage(num_colors);
         total_weight = 0;
+        color_weights.assign(getNumColors(), 0);
 
         (Ext::reset_impl(), ...);
     }
@@ -84,18 +247,17 @@ public:
     // Return `true` if `vertex` does not have an incident arc colored with `color`,
     // `false` otherwise.
     bool is_color_free(Vertex* vertex, color_t color) const {
-        return color != UNCOLORED && mates_by_color[color][vertex] == nullptr;
+        return color != UNCOLORED && !Storage::has_mate(color, vertex);
     }
 
     color_t get_color(Arc* arc) const {
-        return arc_colors[arc];
+        return Storage::stored_color(arc);
     }
 
     // Return `true` if the arc has a valid color assigned, `false` otherwise
     bool is_colored(Arc* arc) const {
         assert(graph->containsArc(arc));
-        //return arc_colors[arc] < num_colors;
-        return arc_colors[arc] < num_colors;
+        return Storage::stored_color(arc) < getNumColors();
     }
 
     // Return `true` if `arc` has no mates for `color`,
@@ -109,16 +271,16 @@ public:
     // Post-condition: `is_colored(arc) == true`
     void color(Arc* arc, color_t color) {
         assert(!is_colored(arc));
-        assert(color < num_colors);
+        assert(color < getNumColors());
         assert(is_color_free(arc->getTail(), color));
         assert(is_color_free(arc->getHead(), color));
 
-        if (arc_colors[arc] == UNCOLORED) {
+        if (Storage::stored_color(arc) == UNCOLORED) {
             total_weight += (*weights)[arc];
+            color_weights[color] += (*weights)[arc];
         }
-        arc_colors.setValue(arc, color);
-        mates_by_color[color][arc->getHead()] = arc->getTail();
-        mates_by_color[color][arc->getTail()] = arc->getHead();
+        Storage::store_color(arc, color);
+        Storage::store_mates(arc, color, (*weights)[arc]);
 
         (Ext::color_impl(arc, color), ...);
 
@@ -130,11 +292,11 @@ public:
     // Post-condition: `is_colored(arc) == false`
     void uncolor(Arc* arc) {
         assert(is_colored(arc));
-        auto color = arc_colors[arc];
-        arc_colors.setValue(arc, UNCOLORED);
-        mates_by_color[color][arc->getHead()] = nullptr;
-        mates_by_color[color][arc->getTail()] = nullptr;
+        auto color = Storage::stored_color(arc);
+        Storage::store_color(arc, UNCOLORED);
+        Storage::clear_mates(arc, color);
         total_weight -= (*weights)[arc];
+        color_weights[color] -= (*weights)[arc];
 
         (Ext::uncolor_impl(arc, color), ...);
 
@@ -149,7 +311,7 @@ public:
 
         auto tail = arc->getTail();
         auto head = arc->getHead();
-        auto arc_color = arc_colors[arc];
+        auto arc_color = Storage::stored_color(arc);
         EdgeWeight tail_weight = 0, head_weight = 0;
         Arc *tail_arc = nullptr, *head_arc = nullptr;
         Vertex *tail_arc_target = nullptr;
@@ -196,7 +358,7 @@ public:
 
 
     auto color_range() const {
-        return boost::irange<color_t>(0, num_colors);
+        return boost::irange<color_t>(0, getNumColors());
     }
 
 
@@ -206,7 +368,7 @@ public:
 
     void setWeights(ModifiableProperty<EdgeWeight> *weights) {
         this->weights = weights;
-        this->weights->onPropertyChange(this, std::bind(&KColoring::onEdgeWeightChange,
+        this->weights->onPropertyChange(this, std::bind(&BasicKColoring::onEdgeWeightChange,
                                                         this,
                                                         std::placeholders::_1,
                                                         std::placeholders::_2,
@@ -227,22 +389,53 @@ public:
     void setNumColors(color_t num_colors) {
         this->num_colors = num_colors;
 
+        Storage::set_num_colors_storage(num_colors);
+        color_weights.resize(getNumColors(), 0);
         (Ext::setNumColors_impl(num_colors), ...);
     }
 
     color_t getNumColors() const {
-        return num_colors;
+        if constexpr (Storage::fixed_colors > 0) {
+            return Storage::fixed_colors;
+        } else {
+            return num_colors;
+        }
     }
 
     EdgeWeight getTotalWeight() const {
         return total_weight;
     }
 
+    // Sum of weights of the edges colored with one of the first `count` colors
+    EdgeWeight getWeightOfFirstColors(color_t count) const {
+        count = std::min<color_t>(count, color_weights.size());
+        return std::accumulate(color_weights.begin(), color_weights.begin() + count, EdgeWeight{0});
+    }
+
     void sanityCheck() {
         checkIncidentEdges();
         checkSolutionWeight();
     };
 
+    // Hash of the color assignment, independent of the order in which arcs are stored.
+    // Equal colorings of graphs built by the same sequence of operations have equal fingerprints.
+    std::uint64_t fingerprint() const {
+        auto mix = [](std::uint64_t x) {
+            x ^= x >> 30;
+            x *= 0xbf58476d1ce4e5b9ULL;
+            x ^= x >> 27;
+            x *= 0x94d049bb133111ebULL;
+            return x ^ (x >> 31);
+        };
+        std::uint64_t hash = 0;
+        graph->mapArcs([&](Arc* arc) {
+            if (is_colored(arc)) {
+                hash += mix(mix(mix(arc->getTail()->getId()) ^ arc->getHead()->getId()) ^ get_color(arc));
+            }
+        });
+        return hash;
+    }
+
 protected:
 
     // Update the total weight when the weight of an arc changes
@@ -250,8 +443,12 @@ protected:
         auto arc = static_cast<Arc*>(artifact);
         assert(graph->containsArc(arc));
         if (is_colored(arc)) {
+            const auto color = Storage::stored_color(arc);
             total_weight -= old_value;
             total_weight += new_value;
+            color_weights[color] -= old_value;
+            color_weights[color] += new_value;
+            Storage::set_mate_weight(arc, color, new_value);
         }
     }
 
@@ -260,11 +457,11 @@ protected:
             color_set unused_colors{num_colors};
             graph->mapIncidentArcs(vertex, [this, &unused_colors, vertex](Arc* arc){
                 if (is_colored(arc)) {
-                    auto c = arc_colors[arc];
+                    auto c = Storage::stored_color(arc);
                     if (!unused_colors[c]) {
                         std::cout << "Color " << c << " used at least twice on vertex " << vertex << ":" << std::endl;
                         graph->mapIncidentArcs(vertex, [this, c](Arc* a) {
-                            if (arc_colors[a] == c) {
+                            if (Storage::stored_color(a) == c) {
                                 std::cout << "  on arc " << a << std::endl;
                             }
                         });
@@ -300,13 +497,31 @@ private:
     // How many colors can be used
     color_t num_colors;
 
-    // Map from edges to colors.
-    // Values are either in `[0,num_colors-1]`, or `UNCOLORED`
-    FastPropertyMap<color_t> arc_colors{UNCOLORED};
-
     // Sum of weights of all colored edges
     EdgeWeight total_weight = 0;
-
-    std::vector<FastPropertyMap<Vertex*>> mates_by_color;
+    // Sum of weights of the edges of each color
+    std::vector<EdgeWeight> color_weights;
 
 };
+
+// Tag selecting a `KColoring` with `K` colors fixed at compile time, see `FixedColorStorage`.
+// It must be the first extension.
+template<color_t K>
+struct FixedColors {};
+
+namespace kcoloring_detail {
+    template<typename... Ext>
+    struct select_kcoloring {
+        using type = BasicKColoring<DynamicColorStorage, Ext...>;
+    };
+
+    template<color_t K, typename... Ext>
+    struct select_kcoloring<FixedColors<K>, Ext...> {
+        using type = BasicKColoring<FixedColorStorage<K>, Ext...>;
+    };
+}
+
+// Edge-coloring with the extensions `Ext`, whose number of colors is set at runtime,
+// or `K` colors if the first extension is `FixedColors<K>`.
+template<typename... Ext>
+using KColoring = typename kcoloring_detail::select_kcoloring<Ext...>::type;
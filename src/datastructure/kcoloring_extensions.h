@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <utility>
 
@@ -36,93 +37,6 @@
 
 using namespace Algora;
 
-// Store for each vertex and each color the arc to the mate.
-class ArcMateExtension {
-
-public:
-
-    std::pair<AdjacentArcWeightPair, color_t> lightest_adjacent_colored_arcs(const Arc *arc, ModifiableProperty<EdgeWeight> *weights) const {
-        auto return_value = AdjacentArcWeightPair{nullptr, nullptr, std::numeric_limits<EdgeWeight>::max()};
-        color_t min_color = UNCOLORED;
-        for (size_t col = 0; col < arcs_to_mates_by_color.size(); ++col) {
-            const auto &map = arcs_to_mates_by_color[col];
-            auto tail_arc = map[arc->getTail()];
-            auto head_arc = map[arc->getHead()];
-            EdgeWeight weight = 0;
-            for (auto a: {tail_arc, head_arc}) {
-                if (a != nullptr) {
-                    weight += (*weights)[a];
-                }
-            }
-            if (weight < return_value.weight) {
-                return_value = {tail_arc, head_arc, weight};
-                min_color = col;
-            }
-        }
-        return {return_value, min_color};
-    }
-
-    Arc* getArcToMate(color_t col, Vertex* vertex) const {
-        return arcs_to_mates_by_color[col][vertex];
-    }
-
-    std::vector<Arc*> getColoredArcs(Vertex* vertex) const {
-        std::vector<Arc*> colored_arcs;
-        colored_arcs.reserve(arcs_to_mates_by_color.size());
-        for (const auto &map: arcs_to_mates_by_color) {
-            if (map[vertex] != nullptr) {
-                colored_arcs.push_back(map[vertex]);
-            }
-        }
-        return colored_arcs;
-    }
-
-    Arc* getLightestColoredEdge(Vertex* vertex, ModifiableProperty<EdgeWeight> *weights) {
-        Arc *lightest = nullptr;
-        EdgeWeight min_weight = std::numeric_limits<EdgeWeight>::max();
-        for (const auto &map: arcs_to_mates_by_color) {
-            if (map[vertex] != nullptr && (*weights)[map[vertex]] < min_weight) {
-                lightest = map[vertex];
-                min_weight = (*weights)[map[vertex]];
-            }
-        }
-        return lightest;
-    }
-
-protected:
-    void reset_impl() {
-        for(auto &map: arcs_to_mates_by_color) {
-            map.setDefaultValue(nullptr);
-            map.resetAll();
-        }
-    }
-
-    void color_impl(Arc *arc, color_t color) {
-        assert(arcs_to_mates_by_color[color][arc->getHead()] == nullptr);
-        assert(arcs_to_mates_by_color[color][arc->getTail()] == nullptr);
-        arcs_to_mates_by_color[color][arc->getHead()] = arc;
-        arcs_to_mates_by_color[color][arc->getTail()] = arc;
-    }
-
-    void uncolor_impl(Arc *arc, color_t pre_color) {
-        assert(arcs_to_mates_by_color[pre_color][arc->getHead()] != nullptr);
-        assert(arcs_to_mates_by_color[pre_color][arc->getTail()] != nullptr);
-        arcs_to_mates_by_color[pre_color][arc->getHead()] = nullptr;
-        arcs_to_mates_by_color[pre_color][arc->getTail()] = nullptr;
-    }
-
-    void setNumColors_impl(color_t num_colors) {
-        arcs_to_mates_by_color.resize(num_colors);
-        for (auto &map: arcs_to_mates_by_color) {
-            map.setDefaultValue(nullptr);
-        }
-    }
-
-private:
-    // Arcs to mates, for each color
-    std::vector<FastPropertyMap<Arc*>> arcs_to_mates_by_color;
-};
-
 // Store for each vertex the colors that are still free.
 class FreeColorsExtension {
 
@@ -132,7 +46,7 @@ public:
     }
 
     color_t common_free_color(Vertex* v1, Vertex* v2) const {
-        return color_set::common_colors(free_colors[v1], free_colors[v2]).find_first();
+        return color_set::first_common(free_colors[v1], free_colors[v2]);
     }
 
     bool any_color_free(Vertex* v1) const {
@@ -186,28 +100,43 @@ public:
         int recolor_count = 0;
     };
 
+    // Change of the color of the arc from `tail` to `head` (by vertex id) within a round,
+    // where either color may be `UNCOLORED`
+    struct arc_change {
+        std::uint64_t tail;
+        std::uint64_t head;
+        color_t old_color;
+        color_t new_color;
+    };
+
 public:
+    // End the current round: count the arcs whose color changed since the previous call
+    // and keep them for `get_changes`. This only visits the arcs touched in the round.
     void compute_coarse_counts_and_reset() {
         coarse_counts = {0, 0, 0};
-        for (auto &diff: arc_color_changes) {
-            if (diff.first == UNCOLORED && diff.second != UNCOLORED) {
+        changes.clear();
+        for (const auto &change: touched) {
+            if (change.old_color == change.new_color) {
+                continue;
+            }
+            if (change.old_color == UNCOLORED) {
                 coarse_counts.color_count++;
-            } else if (diff.first != UNCOLORED && diff.second == UNCOLORED) {
+            } else if (change.new_color == UNCOLORED) {
                 coarse_counts.uncolor_count++;
-            } else if (diff.first != diff.second &&
-                    diff.first != UNCOLORED &&
-                    diff.second != UNCOLORED) {
+            } else {
                 coarse_counts.recolor_count++;
             }
-            // Make the 'new' color the 'old' color so we can keep track of the next changes
-            diff.first = diff.second;
-            diff.second = UNCOLORED;
+            changes.push_back(change);
         }
+        touched.clear();
+        round++;
     }
 
     void reset_arc_diffs() {
-        arc_color_changes.setDefaultValue({UNCOLORED, UNCOLORED});
-        arc_color_changes.resetAll();
+        arc_states.clear();
+        touched.clear();
+        changes.clear();
+        round = 1;
     }
 
     void reset_fine_counts() {
@@ -222,26 +151,74 @@ public:
         return fine_counts;
     }
 
+    // Arcs whose color changed in the last completed round, in the order in which they were first touched
+    const std::vector<arc_change>& get_changes() const {
+        return changes;
+    }
+
 protected:
     void reset_impl() {
         fine_counts = {0, 0, 0};
         coarse_counts = {0, 0, 0};
+        // All arcs lose their colors at once; recoloring them within the round cancels out.
+        for (std::size_t id = 0; id < arc_states.size(); id++) {
+            auto &state = arc_states[id];
+            if (state.color != UNCOLORED) {
+                touch(id, state.tail, state.head, state.color).new_color = UNCOLORED;
+                state.color = UNCOLORED;
+            }
+        }
     }
 
     void color_impl(Arc *arc, color_t color) {
         fine_counts.color_count++;
-        arc_color_changes[arc].second = color;
+        const auto id = arc->getId();
+        if (id >= arc_states.size()) {
+            arc_states.resize(id + 1);
+        }
+        touch(id, arc->getTail()->getId(), arc->getHead()->getId(), UNCOLORED).new_color = color;
+        arc_states[id].color = color;
     }
 
-    void uncolor_impl(Arc *arc, color_t /*pre_color*/) {
+    void uncolor_impl(Arc *arc, color_t pre_color) {
         fine_counts.uncolor_count++;
-        arc_color_changes[arc].second = UNCOLORED;
+        const auto id = arc->getId();
+        touch(id, arc->getTail()->getId(), arc->getHead()->getId(), pre_color).new_color = UNCOLORED;
+        arc_states[id].color = UNCOLORED;
     }
 
     void setNumColors_impl(color_t /*num_colors*/) {}
 
 private:
-    FastPropertyMap<std::pair<color_t, color_t>> arc_color_changes{{UNCOLORED, UNCOLORED}};
+    // State of an arc by id. `color` mirrors the coloring, so that `reset_impl` can tell which arcs
+    // lose their colors; the endpoints are kept as the arc may be gone by the end of the round.
+    struct arc_state {
+        std::uint64_t tail = 0;
+        std::uint64_t head = 0;
+        color_t color = UNCOLORED;
+        // Round in which the arc was last touched, and the index of its entry in `touched`
+        std::uint64_t round = 0;
+        std::size_t entry = 0;
+    };
+
+    // Return the entry of the arc `id` in `touched`, adding one with color `old_color` on its first touch
+    // in this round. Arc ids may be reused within a round, so an arc with other endpoints gets its own entry.
+    arc_change& touch(std::size_t id, std::uint64_t tail, std::uint64_t head, color_t old_color) {
+        auto &state = arc_states[id];
+        if (state.round != round || state.tail != tail || state.head != head) {
+            state.tail = tail;
+            state.head = head;
+            state.round = round;
+            state.entry = touched.size();
+            touched.push_back({tail, head, old_color, old_color});
+        }
+        return touched[state.entry];
+    }
+
+    std::vector<arc_state> arc_states;
+    std::vector<arc_change> touched;
+    std::vector<arc_change> changes;
+    std::uint64_t round = 1;
 
     color_op_counts fine_counts;
     color_op_counts coarse_counts;
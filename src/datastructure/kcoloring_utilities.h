@@ -32,13 +32,17 @@
     #include <queue>
 #endif
 
+#include <unordered_set>
+#include <vector>
+
 #include "datastructure/kcoloring.h"
 #include "datastructure/kcoloring_extensions.h"
+#include "tools/deadline.h"
 #include "tools/utility.h"
 
 // Compute a fan in a `KColoring` of `diGraph`.
 // `kcoloring_type` is expected to be a specialization of `KColoring<...>`,
-// with (at least) the `ArcMateExtension` and the `FreeColorsExtension`.
+// with (at least) the `FreeColorsExtension`, or with `FixedColors`.
 //
 // This is based on the `quicker_fan` function in the old version of the k-edge-coloring algorithm.
 template<typename kcoloring_type>
@@ -91,8 +95,7 @@ void rotate_fan(kcoloring_type &coloring,
 }
 
 // Invert the `cd`-path starting at `x` in `coloring`.
-// `kcoloring_type` is expected to be a specialization of `KColoring<...>`,
-// with (at least) the `ArcMateExtension`.
+// `kcoloring_type` is expected to be a specialization of `KColoring<...>`.
 //
 // This is based on the `invert_cd_path_it` function in the old version of the k-edge-coloring algorithm.
 template<typename kcoloring_type>
@@ -162,11 +165,39 @@ namespace make_maximal_detail {
                                             pq_element_compare_max>;
     #endif
 
+    // Check the invariant for the uncolored arc `arc` of weight `arc_weight` that has no common free color:
+    // for each color, `arc` should have at least one adjacent arc that's heavier, or the adjacent arcs of that
+    // color should weigh at least as much in total. If there is a color where this does not hold, uncolor the
+    // adjacent arcs of this color, passing each to `on_uncolored`, and color `arc` instead.
+    // An antiparallel arc is adjacent at both ends, but only counted and uncolored once.
+    template<typename kcoloring_type, typename F>
+    void replace_lighter_adjacent_arcs(kcoloring_type &coloring, Arc *arc, EdgeWeight arc_weight, F on_uncolored) {
+        auto color = coloring.first_color_lighter_than(arc, arc_weight);
+        if (color == UNCOLORED) {
+            return;
+        }
+        auto atm_tail = coloring.getArcToMate(color, arc->getTail());
+        auto atm_head = coloring.getArcToMate(color, arc->getHead());
+        for (auto a: {atm_tail, atm_head}) {
+            if (a != nullptr && coloring.is_colored(a)) {
+                coloring.uncolor(a);
+                on_uncolored(a);
+            }
+        }
+        coloring.color(arc, color);
+    }
+
+    // Process `queue` until it is empty or `deadline` expires. In the latter case, the coloring is valid,
+    // but the arcs remaining in `queue` may violate the invariant. Returns `true` if `queue` is empty.
     template<typename kcoloring_type>
-    void process_maximal_pq(pq_type& queue,
+    bool process_maximal_pq(pq_type& queue,
                             kcoloring_type &coloring,
-                            ModifiableProperty<EdgeWeight> *weights) {
+                            ModifiableProperty<EdgeWeight> *weights,
+                            Deadline *deadline = nullptr) {
         while (!queue.empty()) {
+            if (deadline != nullptr && deadline->expired()) {
+                return false;
+            }
             Arc* arc = queue.top().first;
             EdgeWeight arc_weight = queue.top().second;
             queue.pop();
@@ -176,44 +207,22 @@ namespace make_maximal_detail {
                 coloring.color(arc, col);
                 continue;
             }
-            // Now check if the invariant holds for all colors.
-            // For each color, the uncolored arc `arc` should have at least one neighbor that's heavier.
-            // If we find a color where this does not hold, we uncolor the adjacent colored edges,
-            // and color `arc` instead.
-            for (auto color: coloring.color_range()) {
-                auto atm_tail = coloring.getArcToMate(color, arc->getTail());
-                auto atm_head = coloring.getArcToMate(color, arc->getHead());
-                bool one_heavier_neighbor = false;
-                EdgeWeight sum_weight = 0;
-                if (atm_tail != nullptr) {
-                    const auto tail_weight = (*weights)[atm_tail];
-                    one_heavier_neighbor |= (tail_weight >= arc_weight);
-                    sum_weight += tail_weight;
-                }
-                if (atm_head != nullptr) {
-                    const auto head_weight = (*weights)[atm_head];
-                    one_heavier_neighbor |= (head_weight >= arc_weight);
-                    sum_weight += head_weight;
-                }
-                if (!one_heavier_neighbor && sum_weight < arc_weight) {
-                    for (auto a: {atm_tail, atm_head}) {
-                        if (a != nullptr) {
-                            coloring.uncolor(a);
-                            queue.push({a, (*weights)[a]});
-                        }
-                    }
-                    coloring.color(arc, color);
-                    break;
-                }
-            }
+            replace_lighter_adjacent_arcs(coloring, arc, arc_weight, [&](Arc *a) {
+                queue.push({a, (*weights)[a]});
+            });
         }
+        return true;
     }
 }
 
+// Make `coloring` maximal, or stop with a valid coloring once `deadline` expires.
+// Uncolored arcs left unprocessed are then appended to `unfinished`, if given.
 template<typename kcoloring_type>
 void make_coloring_maximal_pq(kcoloring_type &coloring,
                               DiGraph *diGraph,
-                              ModifiableProperty<EdgeWeight> *weights) {
+                              ModifiableProperty<EdgeWeight> *weights,
+                              Deadline *deadline = nullptr,
+                              std::vector<Arc*> *unfinished = nullptr) {
     using namespace make_maximal_detail;
 
     auto queue = pq_type{};
@@ -223,7 +232,11 @@ void make_coloring_maximal_pq(kcoloring_type &coloring,
         }
     });
 
-    process_maximal_pq(queue, coloring, weights);
+    if (!process_maximal_pq(queue, coloring, weights, deadline) && unfinished != nullptr) {
+        for (; !queue.empty(); queue.pop()) {
+            unfinished->push_back(queue.top().first);
+        }
+    }
 }
 
 template<typename kcoloring_type>
@@ -251,36 +264,9 @@ void make_coloring_maximal_fixpoint(kcoloring_type &coloring,
                 coloring.color(arc, col);
                 continue;
             }
-            // Now check if the invariant holds for all colors.
-            // For each color, the uncolored arc `arc` should have at least one neighbor that's heavier.
-            // If we find a color where this does not hold, we uncolor the adjacent colored edges,
-            // and color `arc` instead.
-            for (auto color: coloring.color_range()) {
-                auto atm_tail = coloring.getArcToMate(color, arc->getTail());
-                auto atm_head = coloring.getArcToMate(color, arc->getHead());
-                bool one_heavier_neighbor = false;
-                EdgeWeight sum_weight = 0;
-                if (atm_tail != nullptr) {
-                    const auto tail_weight = (*weights)[atm_tail];
-                    one_heavier_neighbor |= (tail_weight >= arc_weight);
-                    sum_weight += tail_weight;
-                }
-                if (atm_head != nullptr) {
-                    const auto head_weight = (*weights)[atm_head];
-                    one_heavier_neighbor |= (head_weight >= arc_weight);
-                    sum_weight += head_weight;
-                }
-                if (!one_heavier_neighbor && sum_weight < arc_weight) {
-                    for (auto a: {atm_tail, atm_head}) {
-                        if (a != nullptr) {
-                            coloring.uncolor(a);
-                            next_arcs_to_process.push_back(a);
-                        }
-                    }
-                    coloring.color(arc, color);
-                    break;
-                }
-            }
+            make_maximal_detail::replace_lighter_adjacent_arcs(coloring, arc, arc_weight, [&](Arc *a) {
+                next_arcs_to_process.push_back(a);
+            });
         }
         std::swap(arcs_to_process, next_arcs_to_process);
         next_arcs_to_process.clear();
@@ -295,21 +281,62 @@ public:
         arcs_to_process.add(arc);
     }
 
-    void perform_post_processing(kcoloring_type &coloring, ModifiableProperty<EdgeWeight>* weights) {
+    // Register `arc` for the next round, as the post-processing of an earlier round did not get to it.
+    void carry_arc(Arc* arc) {
+        if (carried_arcs.insert(arc).second) {
+            carried_order.push_back(arc);
+        }
+    }
+
+    // Stop carrying `arc` over, e.g., because it is removed from the graph.
+    void discard_arc(Arc* arc) {
+        if (!carried_arcs.empty()) {
+            carried_arcs.erase(arc);
+        }
+    }
+
+    // Process the registered arcs, including those carried over from earlier rounds.
+    // If `deadline` expires, the remaining arcs are carried over into the next round.
+    void perform_post_processing(kcoloring_type &coloring, ModifiableProperty<EdgeWeight>* weights,
+                                 Deadline *deadline = nullptr) {
         using namespace make_maximal_detail;
 
+        // Take the carried arcs in the order in which they were carried, not in that of their addresses,
+        // so that repeated runs process them alike
+        for (auto arc: carried_order) {
+            if (carried_arcs.erase(arc) > 0) {
+                arcs_to_process.add(arc);
+            }
+        }
+        carried_order.clear();
         priority_queue = {};
         for (auto arc: arcs_to_process.vector()) {
             if ((*weights)[arc] > 0 && !coloring.is_colored(arc)) {
                 priority_queue.push({arc, (*weights)[arc]});
             }
         } 
-        process_maximal_pq(priority_queue, coloring, weights);
+        if (!process_maximal_pq(priority_queue, coloring, weights, deadline)) {
+            for (; !priority_queue.empty(); priority_queue.pop()) {
+                carry_arc(priority_queue.top().first);
+            }
+        }
         arcs_to_process.next_round();
     }
 
+    // Forget all registered arcs, e.g., when the algorithm is run on a new graph.
+    void reset() {
+        arcs_to_process.reset();
+        carried_arcs.clear();
+        carried_order.clear();
+    }
+
 private:
     TimedArtifactSet<Arc*> arcs_to_process;
+    // Arcs left over by an interrupted post-processing; these may have been removed from the graph
+    // since, so they are only dereferenced if they have not been discarded.
+    std::unordered_set<Arc*> carried_arcs;
+    // Carried arcs in the order in which they were carried, including discarded ones
+    std::vector<Arc*> carried_order;
     make_maximal_detail::pq_type priority_queue;
 
 };
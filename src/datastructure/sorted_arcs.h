@@ -0,0 +1,89 @@
+/**
+ * Copyright (C) 2022-2023 : Kathrin Hanauer, Lara Ost
+ *
+ * This file is part of DyDJ Match.
+ *
+ * DyDJ Match is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DyDJ Match is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DyDJ Match.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact information:
+ *   https://github.com/DJ-Match/DyDJ-Match
+ */
+
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "graph/arc.h"
+#include "graph/digraph.h"
+#include "property/modifiableproperty.h"
+
+#include "algorithm/matching_defs.h"
+
+using namespace Algora;
+
+// The arcs of positive weight of a graph, sorted by non-increasing weight, for several algorithms
+// observing the same graph, e.g., for different numbers of matchings.
+// The order is computed on the first request after the graph or its weights changed, such that the
+// algorithms running on the same delta sort the arcs only once. It is identical to the order
+// obtained by sorting the arcs of `graph->mapArcs` locally.
+class SortedArcs {
+
+public:
+    SortedArcs(DiGraph *graph, ModifiableProperty<EdgeWeight> *weights) : graph(graph), weights(weights) {
+        graph->onArcAdd(this, [this](Arc*) { valid = false; });
+        graph->onArcRemove(this, [this](Arc*) { valid = false; });
+        weights->onPropertyChange(this, [this](GraphArtifact*, const EdgeWeight&, const EdgeWeight&) {
+            valid = false;
+        });
+    }
+
+    SortedArcs(const SortedArcs&) = delete;
+    SortedArcs& operator=(const SortedArcs&) = delete;
+
+    ~SortedArcs() {
+        graph->removeOnArcAdd(this);
+        graph->removeOnArcRemove(this);
+        weights->removeOnPropertyChange(this);
+    }
+
+    const std::vector<Arc*>& get() {
+        if (!valid) {
+            sort(graph, weights, arcs);
+            valid = true;
+        }
+        return arcs;
+    }
+
+    // Replace `arcs` by the arcs of positive weight of `graph`, sorted by non-increasing weight.
+    static void sort(DiGraph *graph, ModifiableProperty<EdgeWeight> *weights, std::vector<Arc*> &arcs) {
+        arcs.clear();
+        arcs.reserve(graph->getNumArcs(false));
+        graph->mapArcs([weights, &arcs](Arc *arc) {
+            if ((*weights)[arc] > 0) {
+                arcs.push_back(arc);
+            }
+        });
+        std::sort(arcs.begin(), arcs.end(), [weights](const Arc *lop, const Arc *rop) {
+            return (*weights)[lop] > (*weights)[rop];
+        });
+    }
+
+private:
+    DiGraph *graph;
+    ModifiableProperty<EdgeWeight> *weights;
+    std::vector<Arc*> arcs;
+    bool valid = false;
+};
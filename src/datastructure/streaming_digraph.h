@@ -0,0 +1,142 @@
+/**
+ * Copyright (C) 2022-2023 : Kathrin Hanauer, Lara Ost
+ *
+ * This file is part of DyDJ Match.
+ *
+ * DyDJ Match is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DyDJ Match is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DyDJ Match.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact information:
+ *   https://github.com/DJ-Match/DyDJ-Match
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "graph/arc.h"
+#include "graph/vertex.h"
+#include "graph.incidencelist/incidencelistgraph.h"
+#include "property/modifiableproperty.h"
+
+#include "io/trace_update.h"
+
+using namespace Algora;
+
+/*
+ * A weighted digraph that is built by applying deltas one at a time, as opposed to
+ * `DynamicWeightedDiGraph`, which needs to know the whole update history in advance.
+ * Memory usage is proportional to the current graph. Updates are applied with the
+ * semantics of `KonectNetworkReader` with non-positive weights removing arcs:
+ * arcs are added on demand, weight changes are reported via the weight property,
+ * and removals as a weight change to 0 followed by the arc-removal observers of the graph.
+ */
+template<typename T>
+class StreamingWeightedDiGraph {
+
+public:
+    DiGraph* getDiGraph() {
+        return &graph;
+    }
+
+    ModifiableProperty<T>* getArcWeights() {
+        return &weights;
+    }
+
+    // Current weight of the arc `key`, or 0 if it is not present.
+    T getWeight(const TraceArcKey &key) const {
+        auto it = arcs.find(key);
+        return it != arcs.end() ? weights.getValue(it->second) : 0;
+    }
+
+    // Id in the trace of each vertex, by `getId()`.
+    // Vertices are numbered in order of creation, i.e., of first appearance apart from `reserveVertices`.
+    const std::vector<TraceUpdate::vertex_id>& getTraceIds() const {
+        return trace_ids;
+    }
+
+    // Create the vertices with ids `[0, count)` in this order, so that their
+    // `getId()` (and thus their position in property maps) follows their id.
+    void reserveVertices(std::size_t count) {
+        while (dense_vertices.size() < count) {
+            auto id = dense_vertices.size();
+            auto it = vertices.find(id);
+            dense_vertices.push_back(it != vertices.end() ? it->second : addVertex(id));
+        }
+    }
+
+    // Apply all updates of a delta in the given order.
+    void applyDelta(const std::vector<TraceUpdate> &delta) {
+        for (const auto &update : delta) {
+            applyUpdate(update);
+        }
+    }
+
+    void applyUpdate(const TraceUpdate &update) {
+        const TraceArcKey key(update.tail, update.head);
+        if (update.weight > 0) {
+            auto [it, inserted] = arcs.try_emplace(key, nullptr);
+            if (inserted) {
+                it->second = graph.addArc(getVertex(update.tail), getVertex(update.head));
+                assert(trace_ids[it->second->getTail()->getId()] == update.tail);
+                assert(trace_ids[it->second->getHead()->getId()] == update.head);
+            }
+            weights.setValue(it->second, static_cast<T>(update.weight));
+        } else {
+            auto it = arcs.find(key);
+            if (it != arcs.end()) {
+                Arc *arc = it->second;
+                arcs.erase(it);
+                // Report the removal as a weight change to 0 first, once for all observers
+                weights.setValue(arc, 0);
+                graph.removeArc(arc);
+            }
+        }
+    }
+
+private:
+    Vertex* getVertex(TraceUpdate::vertex_id id) {
+        if (id < dense_vertices.size()) {
+            return dense_vertices[id];
+        }
+        auto [it, inserted] = vertices.try_emplace(id, nullptr);
+        if (inserted) {
+            it->second = addVertex(id);
+        }
+        return it->second;
+    }
+
+    Vertex* addVertex(TraceUpdate::vertex_id id) {
+        Vertex *vertex = graph.addVertex();
+        if (vertex->getId() >= trace_ids.size()) {
+            trace_ids.resize(vertex->getId() + 1);
+        }
+        trace_ids[vertex->getId()] = id;
+        return vertex;
+    }
+
+    IncidenceListGraph graph;
+    ModifiableProperty<T> weights;
+    // Vertices created by `reserveVertices`, by id
+    std::vector<Vertex*> dense_vertices;
+    // Any other vertices
+    std::unordered_map<TraceUpdate::vertex_id, Vertex*> vertices;
+    // See `getTraceIds`
+    std::vector<TraceUpdate::vertex_id> trace_ids;
+    std::unordered_map<TraceArcKey, Arc*, TraceArcKeyHash> arcs;
+};
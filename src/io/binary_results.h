@@ -0,0 +1,371 @@
+/**
+ * Copyright (C) 2022-2023 : Kathrin Hanauer, Lara Ost
+ *
+ * This file is part of DyDJ Match.
+ *
+ * DyDJ Match is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DyDJ Match is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DyDJ Match.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact information:
+ *   https://github.com/DJ-Match/DyDJ-Match
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "io/mapped_file.h"
+
+// Typed, columnar binary representation of a result table, which can be memory-mapped by readers.
+//
+// Layout (all fixed-width integers in native byte order, all sections aligned to 8 bytes):
+//   header       see `BinaryResultsHeader`
+//   columns      `num_columns` descriptors, see `BinaryColumnDescriptor`, each followed by its name
+//   padding      zero bytes up to the next multiple of 8
+//   row groups   back to back until the end of the file:
+//                  `BinaryRowGroupHeader`
+//                  `num_strings` strings: uint32 length, followed by the characters
+//                  padding
+//                  per column: `num_rows` values of the width of its type, followed by padding
+//
+// String columns hold indices into the strings of their row group, such that row groups are
+// self-contained and the row groups of several tables with the same columns can be concatenated.
+enum class BinaryColumnType : std::uint8_t {
+    INT32 = 0,
+    INT64 = 1,
+    UINT32 = 2,
+    UINT64 = 3,
+    FLOAT64 = 4,
+    STRING = 5
+};
+
+inline const std::array<const char*, 6> binary_column_type_names = {"int32", "int64", "uint32", "uint64",
+                                                                    "float64", "string"};
+
+// Type of the column storing values of type `T`
+template<typename T>
+constexpr BinaryColumnType binary_column_type() {
+    if constexpr (std::is_same_v<T, std::string>) {
+        return BinaryColumnType::STRING;
+    } else if constexpr (std::is_floating_point_v<T>) {
+        static_assert(sizeof(T) == 8, "Only 64-bit floating point columns are supported");
+        return BinaryColumnType::FLOAT64;
+    } else {
+        static_assert(std::is_integral_v<T> && (sizeof(T) == 4 || sizeof(T) == 8),
+                      "Only 32- and 64-bit integer columns are supported");
+        if constexpr (std::is_signed_v<T>) {
+            return sizeof(T) == 4 ? BinaryColumnType::INT32 : BinaryColumnType::INT64;
+        } else {
+            return sizeof(T) == 4 ? BinaryColumnType::UINT32 : BinaryColumnType::UINT64;
+        }
+    }
+}
+
+// Width in bytes of a value of a column of type `type`
+constexpr std::size_t binary_column_width(BinaryColumnType type) {
+    switch (type) {
+        case BinaryColumnType::INT32:
+        case BinaryColumnType::UINT32:
+        case BinaryColumnType::STRING:
+            return 4;
+        default:
+            return 8;
+    }
+}
+
+struct BinaryResultsHeader {
+    static constexpr char expected_magic[8] = {'D', 'Y', 'D', 'J', 'R', 'E', 'S', '\0'};
+    static constexpr std::uint32_t current_version = 1;
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t num_columns;
+};
+
+struct BinaryColumnDescriptor {
+    BinaryColumnType type;
+    std::uint8_t reserved;
+    std::uint16_t name_length;
+};
+
+struct BinaryRowGroupHeader {
+    // Size of the row group in bytes, including this header
+    std::uint64_t size;
+    std::uint32_t num_rows;
+    std::uint32_t num_strings;
+};
+
+namespace binary_results_detail {
+
+inline void write_padding(std::ostream &stream, std::size_t size) {
+    static constexpr char zeros[8] = {};
+    stream.write(zeros, (8 - size % 8) % 8);
+}
+
+inline std::size_t padded(std::size_t size) {
+    return (size + 7) / 8 * 8;
+}
+
+}
+
+// Write the header of a table with columns `names` of types `types`.
+inline void write_binary_results_header(std::ostream &stream, const std::vector<std::string> &names,
+                                        const std::vector<BinaryColumnType> &types) {
+    BinaryResultsHeader header{};
+    std::memcpy(header.magic, BinaryResultsHeader::expected_magic, sizeof(header.magic));
+    header.version = BinaryResultsHeader::current_version;
+    header.num_columns = names.size();
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    std::size_t size = sizeof(header);
+    for (std::size_t i = 0; i < names.size(); i++) {
+        BinaryColumnDescriptor descriptor{types[i], 0, static_cast<std::uint16_t>(names[i].size())};
+        stream.write(reinterpret_cast<const char*>(&descriptor), sizeof(descriptor));
+        stream.write(names[i].data(), names[i].size());
+        size += sizeof(descriptor) + names[i].size();
+    }
+    binary_results_detail::write_padding(stream, size);
+}
+
+// Collects rows column by column and writes them as a row group.
+class BinaryRowGroupWriter {
+
+public:
+    explicit BinaryRowGroupWriter(std::size_t num_columns) : columns(num_columns) {}
+
+    // Set the value of `column` in the current row
+    template<typename T>
+    void add(std::size_t column, const T &value) {
+        if constexpr (std::is_same_v<T, std::string>) {
+            auto [it, inserted] = string_indices.try_emplace(value, strings.size());
+            if (inserted) {
+                strings.push_back(value);
+            }
+            append(column, static_cast<std::uint32_t>(it->second));
+        } else {
+            append(column, value);
+        }
+    }
+
+    // Finish the current row
+    void end_row() {
+        rows++;
+    }
+
+    std::uint32_t num_rows() const {
+        return rows;
+    }
+
+    // Write the rows collected so far as a row group, if any, and start a new one
+    void write(std::ostream &stream) {
+        using namespace binary_results_detail;
+        if (rows == 0) {
+            return;
+        }
+        std::size_t strings_size = 0;
+        for (const auto &string : strings) {
+            strings_size += sizeof(std::uint32_t) + string.size();
+        }
+        BinaryRowGroupHeader header{sizeof(BinaryRowGroupHeader) + padded(strings_size), rows,
+                                    static_cast<std::uint32_t>(strings.size())};
+        for (const auto &column : columns) {
+            header.size += padded(column.size());
+        }
+        stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (const auto &string : strings) {
+            const auto length = static_cast<std::uint32_t>(string.size());
+            stream.write(reinterpret_cast<const char*>(&length), sizeof(length));
+            stream.write(string.data(), string.size());
+        }
+        write_padding(stream, strings_size);
+        for (auto &column : columns) {
+            stream.write(column.data(), column.size());
+            write_padding(stream, column.size());
+            column.clear();
+        }
+        rows = 0;
+        strings.clear();
+        string_indices.clear();
+    }
+
+private:
+    template<typename T>
+    void append(std::size_t column, const T &value) {
+        const auto *bytes = reinterpret_cast<const char*>(&value);
+        columns[column].insert(columns[column].end(), bytes, bytes + sizeof(value));
+    }
+
+    std::vector<std::vector<char>> columns;
+    std::uint32_t rows = 0;
+    std::vector<std::string> strings;
+    std::unordered_map<std::string, std::size_t> string_indices;
+};
+
+// A row group of a memory-mapped table
+struct BinaryRowGroup {
+    std::uint32_t num_rows;
+    std::vector<std::string_view> strings;
+    std::vector<const unsigned char*> columns;
+
+    // Values of `column`, which must be stored as type `T`
+    template<typename T>
+    const T* values(std::size_t column) const {
+        return reinterpret_cast<const T*>(columns[column]);
+    }
+
+    // Value of the string column `column` in `row`
+    std::string_view string(std::size_t column, std::size_t row) const {
+        return strings[values<std::uint32_t>(column)[row]];
+    }
+};
+
+// Memory-maps a table in the binary results format.
+class BinaryResultsReader {
+
+public:
+    struct Column {
+        std::string name;
+        BinaryColumnType type;
+    };
+
+    // Return `true` if `filename` starts with the magic bytes of the binary results format.
+    static bool is_binary_results(const std::string &filename) {
+        std::ifstream file(filename, std::ios::binary);
+        char magic[sizeof(BinaryResultsHeader::expected_magic)];
+        return file.read(magic, sizeof(magic)) &&
+               std::memcmp(magic, BinaryResultsHeader::expected_magic, sizeof(magic)) == 0;
+    }
+
+    // Map `filename` and index its row groups
+    bool open(const std::string &filename) {
+        using binary_results_detail::padded;
+        columns.clear();
+        row_groups.clear();
+        rows = 0;
+        if (!file.open(filename)) {
+            std::cerr << "Could not map file " << filename << std::endl;
+            return false;
+        }
+        BinaryResultsHeader header;
+        if (file.size() < sizeof(header)) {
+            std::cerr << filename << " is too small to be a binary results file" << std::endl;
+            return false;
+        }
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.magic, BinaryResultsHeader::expected_magic, sizeof(header.magic)) != 0 ||
+                header.version != BinaryResultsHeader::current_version) {
+            std::cerr << filename << " is not a binary results file of version "
+                      << BinaryResultsHeader::current_version << std::endl;
+            return false;
+        }
+        std::size_t offset = sizeof(header);
+        for (std::uint32_t i = 0; i < header.num_columns; i++) {
+            BinaryColumnDescriptor descriptor;
+            if (offset + sizeof(descriptor) > file.size()) {
+                return truncated(filename);
+            }
+            std::memcpy(&descriptor, file.data() + offset, sizeof(descriptor));
+            offset += sizeof(descriptor);
+            if (offset + descriptor.name_length > file.size() ||
+                    static_cast<std::size_t>(descriptor.type) >= binary_column_type_names.size()) {
+                return truncated(filename);
+            }
+            columns.push_back({std::string(reinterpret_cast<const char*>(file.data() + offset),
+                                           descriptor.name_length),
+                               descriptor.type});
+            offset += descriptor.name_length;
+        }
+        offset = padded(offset);
+        while (offset < file.size()) {
+            BinaryRowGroupHeader group_header;
+            if (offset + sizeof(group_header) > file.size()) {
+                return truncated(filename);
+            }
+            std::memcpy(&group_header, file.data() + offset, sizeof(group_header));
+            const auto end = offset + group_header.size;
+            if (group_header.size < sizeof(group_header) || end > file.size()) {
+                return truncated(filename);
+            }
+            BinaryRowGroup group;
+            group.num_rows = group_header.num_rows;
+            auto position = offset + sizeof(group_header);
+            for (std::uint32_t i = 0; i < group_header.num_strings; i++) {
+                std::uint32_t length;
+                if (position + sizeof(length) > end) {
+                    return truncated(filename);
+                }
+                std::memcpy(&length, file.data() + position, sizeof(length));
+                position += sizeof(length);
+                if (position + length > end) {
+                    return truncated(filename);
+                }
+                group.strings.emplace_back(reinterpret_cast<const char*>(file.data() + position), length);
+                position += length;
+            }
+            position = offset + padded(position - offset);
+            for (const auto &column : columns) {
+                group.columns.push_back(file.data() + position);
+                position += padded(group.num_rows * binary_column_width(column.type));
+            }
+            if (position != end) {
+                return truncated(filename);
+            }
+            rows += group.num_rows;
+            row_groups.push_back(std::move(group));
+            offset = end;
+        }
+        file.advise_sequential();
+        return true;
+    }
+
+    const std::vector<Column>& get_columns() const {
+        return columns;
+    }
+
+    // Index of the column called `name`, or the number of columns if there is none
+    std::size_t column_index(const std::string &name) const {
+        std::size_t i = 0;
+        while (i < columns.size() && columns[i].name != name) {
+            i++;
+        }
+        return i;
+    }
+
+    const std::vector<BinaryRowGroup>& get_row_groups() const {
+        return row_groups;
+    }
+
+    std::uint64_t num_rows() const {
+        return rows;
+    }
+
+private:
+    bool truncated(const std::string &filename) {
+        std::cerr << filename << " is truncated" << std::endl;
+        row_groups.clear();
+        return false;
+    }
+
+    MappedFile file;
+    std::vector<Column> columns;
+    std::vector<BinaryRowGroup> row_groups;
+    std::uint64_t rows = 0;
+};
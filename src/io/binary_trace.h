@@ -0,0 +1,309 @@
+/**
+ * Copyright (C) 2022-2023 : Kathrin Hanauer, Lara Ost
+ *
+ * This file is part of DyDJ Match.
+ *
+ * DyDJ Match is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DyDJ Match is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DyDJ Match.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact information:
+ *   https://github.com/DJ-Match/DyDJ-Match
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "io/mapped_file.h"
+#include "io/trace_update.h"
+#include "io/varint.h"
+
+// Compact binary representation of a temporal edge stream.
+//
+// Layout (all fixed-width integers in native byte order):
+//   header       see `BinaryTraceHeader`
+//   deltas       one record per delta, back to back:
+//                  varint  timestamp gap to the previous delta (the first gap is relative to 0)
+//                  varint  number of updates
+//                  per update: varint tail, varint head, zigzag-varint weight
+//   padding      zero bytes up to the next multiple of 8
+//   offset table `num_deltas + 1` x uint64: byte offset of each delta record, plus the end offset
+//   vertex table `num_vertices` x uint64: original vertex id of each dense vertex id
+//
+// Vertex ids are dense, i.e., in `[0, num_vertices)`, in the order of their first appearance.
+// The deltas contain the updates with identical timestamp in file order.
+struct BinaryTraceHeader {
+    static constexpr char expected_magic[8] = {'D', 'Y', 'D', 'J', 'T', 'R', 'C', '\0'};
+    static constexpr std::uint32_t current_version = 1;
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t flags;
+    std::uint64_t num_vertices;
+    std::uint64_t num_updates;
+    std::uint64_t num_deltas;
+    std::uint64_t offset_table_offset;
+    std::uint64_t vertex_table_offset;
+};
+
+// Convert a list of updates into the binary trace format.
+class BinaryTraceWriter {
+
+public:
+    // Write `updates` to `stream`.
+    // Pre-condition: `updates` is sorted by timestamp (stable sorting preserves the file order of a delta).
+    bool write(std::ostream &stream, const std::vector<TraceUpdate> &updates) {
+        assert(std::is_sorted(updates.begin(), updates.end(), [](const TraceUpdate &lop, const TraceUpdate &rop) {
+            return lop.timestamp < rop.timestamp;
+        }));
+
+        std::unordered_map<TraceUpdate::vertex_id, std::uint64_t> dense_ids;
+        std::vector<std::uint64_t> original_ids;
+        auto dense_id = [&dense_ids, &original_ids](TraceUpdate::vertex_id id) {
+            auto [it, inserted] = dense_ids.try_emplace(id, original_ids.size());
+            if (inserted) {
+                original_ids.push_back(id);
+            }
+            return it->second;
+        };
+
+        BinaryTraceHeader header{};
+        std::memcpy(header.magic, BinaryTraceHeader::expected_magic, sizeof(header.magic));
+        header.version = BinaryTraceHeader::current_version;
+        header.num_updates = updates.size();
+        // Reserve space for the header, it is rewritten once all sizes are known.
+        stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        std::vector<std::uint64_t> offsets;
+        std::vector<unsigned char> buffer;
+        std::uint64_t offset = sizeof(header);
+        TraceUpdate::timestamp_type previous_timestamp = 0;
+        for (auto begin = updates.begin(); begin != updates.end(); ) {
+            auto end = std::find_if(begin, updates.end(), [begin](const TraceUpdate &update) {
+                return update.timestamp != begin->timestamp;
+            });
+            buffer.clear();
+            append_varint(buffer, begin->timestamp - previous_timestamp);
+            append_varint(buffer, end - begin);
+            for (auto it = begin; it != end; ++it) {
+                append_varint(buffer, dense_id(it->tail));
+                append_varint(buffer, dense_id(it->head));
+                append_varint(buffer, zigzag_encode(it->weight));
+            }
+            stream.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+            offsets.push_back(offset);
+            offset += buffer.size();
+            previous_timestamp = begin->timestamp;
+            begin = end;
+        }
+        offsets.push_back(offset);
+        // Align the tables so that they can be accessed in place once mapped.
+        const std::uint64_t padding = (sizeof(std::uint64_t) - offset % sizeof(std::uint64_t)) % sizeof(std::uint64_t);
+        stream.write("\0\0\0\0\0\0\0", padding);
+        offset += padding;
+
+        header.num_deltas = offsets.size() - 1;
+        header.num_vertices = original_ids.size();
+        header.offset_table_offset = offset;
+        header.vertex_table_offset = offset + offsets.size() * sizeof(std::uint64_t);
+        stream.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(std::uint64_t));
+        stream.write(reinterpret_cast<const char*>(original_ids.data()), original_ids.size() * sizeof(std::uint64_t));
+        stream.seekp(0);
+        stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        stream.seekp(0, std::ios::end);
+
+        return stream.good();
+    }
+};
+
+// Memory-mapped reader for the binary trace format.
+// Decoding a delta requires no parsing beyond varint decoding, and the mapping
+// itself is shared among all processes that read the same trace.
+class BinaryTraceReader {
+
+public:
+    // Return `true` if `filename` starts with the magic bytes of the binary trace format.
+    static bool is_binary_trace(const std::string &filename) {
+        std::ifstream file(filename, std::ios::binary);
+        char magic[sizeof(BinaryTraceHeader::expected_magic)];
+        return file.read(magic, sizeof(magic)) &&
+               std::memcmp(magic, BinaryTraceHeader::expected_magic, sizeof(magic)) == 0;
+    }
+
+    bool open(const std::string &filename) {
+        if (!file.open(filename)) {
+            std::cerr << "Could not map file " << filename << std::endl;
+            return false;
+        }
+        if (file.size() < sizeof(BinaryTraceHeader)) {
+            std::cerr << filename << " is too small to be a binary trace" << std::endl;
+            return false;
+        }
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.magic, BinaryTraceHeader::expected_magic, sizeof(header.magic)) != 0 ||
+                header.version != BinaryTraceHeader::current_version) {
+            std::cerr << filename << " is not a binary trace of version "
+                      << BinaryTraceHeader::current_version << std::endl;
+            return false;
+        }
+        // Compare counts instead of sizes, such that corrupt headers cannot overflow the computation
+        const std::uint64_t words = file.size() / sizeof(std::uint64_t);
+        if (header.offset_table_offset % sizeof(std::uint64_t) != 0 ||
+                header.vertex_table_offset % sizeof(std::uint64_t) != 0 ||
+                header.offset_table_offset > file.size() || header.vertex_table_offset > file.size() ||
+                header.num_deltas >= words - header.offset_table_offset / sizeof(std::uint64_t) ||
+                header.num_vertices > words - header.vertex_table_offset / sizeof(std::uint64_t)) {
+            std::cerr << filename << " is truncated" << std::endl;
+            return false;
+        }
+        offsets = reinterpret_cast<const std::uint64_t*>(file.data() + header.offset_table_offset);
+        original_ids = reinterpret_cast<const std::uint64_t*>(file.data() + header.vertex_table_offset);
+        // The delta records lie back to back between the header and the offset table
+        bool valid = offsets[0] == sizeof(BinaryTraceHeader) && offsets[header.num_deltas] <= header.offset_table_offset;
+        for (std::uint64_t delta = 0; valid && delta < header.num_deltas; ++delta) {
+            valid = offsets[delta] <= offsets[delta + 1];
+        }
+        if (!valid) {
+            std::cerr << filename << " has an invalid offset table" << std::endl;
+            offsets = nullptr;
+            original_ids = nullptr;
+            return false;
+        }
+        file.advise_sequential();
+        return true;
+    }
+
+    bool is_open() const {
+        return offsets != nullptr;
+    }
+
+    std::uint64_t num_vertices() const {
+        return header.num_vertices;
+    }
+
+    std::uint64_t num_updates() const {
+        return header.num_updates;
+    }
+
+    std::uint64_t num_deltas() const {
+        return header.num_deltas;
+    }
+
+    // Original id (as given in the Konect file) of the dense vertex id `id`.
+    TraceUpdate::vertex_id original_id(std::uint64_t id) const {
+        return original_ids[id];
+    }
+
+    // Original ids of all dense vertex ids, see `original_id`.
+    std::vector<TraceUpdate::vertex_id> vertex_table() const {
+        return std::vector<TraceUpdate::vertex_id>(original_ids, original_ids + header.num_vertices);
+    }
+
+    // Decode the deltas in order, calling `f(timestamp, num_updates)` once per delta
+    // and then `g(update)` for each of its updates. Vertex ids are dense.
+    // Returns `false` if a delta record is malformed.
+    template<typename DeltaF, typename UpdateF>
+    bool map_deltas(DeltaF f, UpdateF g) const {
+        TraceUpdate::timestamp_type timestamp = 0;
+        for (std::uint64_t delta = 0; delta < header.num_deltas; ++delta) {
+            if (!map_delta(delta, timestamp, f, g)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Absolute timestamps of all deltas, decoded from the record headers only.
+    // Returns `false` if a delta record is malformed.
+    bool delta_timestamps(std::vector<TraceUpdate::timestamp_type> &timestamps) const {
+        timestamps.clear();
+        timestamps.reserve(header.num_deltas);
+        TraceUpdate::timestamp_type timestamp = 0;
+        for (std::uint64_t delta = 0; delta < header.num_deltas; ++delta) {
+            const unsigned char *pos = file.data() + offsets[delta];
+            std::uint64_t gap;
+            if (!read_varint(pos, file.data() + offsets[delta + 1], gap)) {
+                return false;
+            }
+            timestamp += gap;
+            timestamps.push_back(timestamp);
+        }
+        return true;
+    }
+
+    // Decode the delta with index `delta` into `updates`, replacing their contents.
+    // `timestamp` must hold the timestamp of the previous delta (0 for the first one)
+    // and is set to the timestamp of the decoded delta.
+    // Returns `false` if the delta record is malformed.
+    bool read_delta(std::uint64_t delta, TraceUpdate::timestamp_type &timestamp,
+                    std::vector<TraceUpdate> &updates) const {
+        updates.clear();
+        return map_delta(delta, timestamp,
+                         [&updates](TraceUpdate::timestamp_type, std::uint64_t count) { updates.reserve(count); },
+                         [&updates](const TraceUpdate &update) { updates.push_back(update); });
+    }
+
+    // Insert all updates into the dynamic graph `dyGraph`, analogous to
+    // `Algora::KonectNetworkReader` with non-positive weights removing arcs.
+    // Returns `false` if a delta record is malformed.
+    template<typename DynamicGraph>
+    bool provideDynamicWeightedDiGraph(DynamicGraph *dyGraph) const {
+        return map_deltas([](TraceUpdate::timestamp_type, std::uint64_t) {},
+                          [dyGraph](const TraceUpdate &update) {
+            apply_trace_update(dyGraph, update);
+        });
+    }
+
+private:
+    // Decode the record of `delta`, which must not extend past the offset of the next record.
+    template<typename DeltaF, typename UpdateF>
+    bool map_delta(std::uint64_t delta, TraceUpdate::timestamp_type &timestamp, DeltaF f, UpdateF g) const {
+        const unsigned char *pos = file.data() + offsets[delta];
+        const unsigned char *end = file.data() + offsets[delta + 1];
+        std::uint64_t gap, count;
+        // Every update takes at least three bytes
+        if (!read_varint(pos, end, gap) || !read_varint(pos, end, count) ||
+                count > static_cast<std::uint64_t>(end - pos) / 3) {
+            return false;
+        }
+        timestamp += gap;
+        f(timestamp, count);
+        for (std::uint64_t i = 0; i < count; ++i) {
+            std::uint64_t tail, head, weight;
+            if (!read_varint(pos, end, tail) || !read_varint(pos, end, head) || !read_varint(pos, end, weight) ||
+                    tail >= header.num_vertices || head >= header.num_vertices) {
+                return false;
+            }
+            TraceUpdate update;
+            update.tail = tail;
+            update.head = head;
+            update.weight = zigzag_decode(weight);
+            update.timestamp = timestamp;
+            g(update);
+        }
+        return true;
+    }
+
+    MappedFile file;
+    BinaryTraceHeader header{};
+    const std::uint64_t *offsets = nullptr;
+    const std::uint64_t *original_ids = nullptr;
+};
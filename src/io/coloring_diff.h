@@ -0,0 +1,251 @@
+/**
+ * Copyright (C) 2022-2023 : Kathrin Hanauer, Lara Ost
+ *
+ * This file is part of DyDJ Match.
+ *
+ * DyDJ Match is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DyDJ Match is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DyDJ Match.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact information:
+ *   https://github.com/DJ-Match/DyDJ-Match
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "algorithm/disjoint_matching_algorithm.h"
+#include "io/compressed_input.h"
+#include "io/varint.h"
+
+// Per-delta stream of the arcs whose color changed, i.e., the matchings to reconfigure after each delta.
+// Colors are numbered from 0; a record with old color `UNCOLORED` adds the arc to a matching,
+// one with new color `UNCOLORED` removes it from its matching.
+//
+// Layout (all fixed-width integers in native byte order):
+//   header    see `ColoringDiffHeader`
+//   blocks    each starting with a varint block type:
+//     RUN     varint b, varint length of the algorithm name, name.
+//             Runs are numbered from 0 in the order of their blocks.
+//     DELTA   varint run, varint delta, varint number of records,
+//               per record: varint tail, varint head, varint old color + 1, varint new color + 1
+//             Vertices are given by their ids in the input file, color 0 stands for `UNCOLORED`.
+// The blocks of different runs may be interleaved, those of a run appear in the order of its deltas.
+struct ColoringDiffHeader {
+    static constexpr char expected_magic[8] = {'D', 'Y', 'D', 'J', 'D', 'I', 'F', '\0'};
+    static constexpr std::uint32_t current_version = 1;
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t flags;
+};
+
+enum class ColoringDiffBlock : std::uint8_t {RUN = 0, DELTA = 1};
+
+struct ColoringDiffRecord {
+    unsigned long long tail;
+    unsigned long long head;
+    color_t old_color;
+    color_t new_color;
+};
+
+struct ColoringDiffRun {
+    std::string algorithm;
+    int b;
+};
+
+// Writes the changes of each (b, algorithm) run per delta to a file.
+// Runs on different threads may write concurrently; each delta is written as a single block.
+class ColoringDiffWriter {
+
+public:
+    // Open `filename` for the runs of the configured `algorithms` (for all b).
+    // Runs are identified by the name of their algorithm and b, so the names have to be distinct.
+    bool open(const std::string &filename, const std::vector<std::string> &algorithms) {
+        std::set<std::string> names;
+        for (const auto &algorithm : algorithms) {
+            if (!names.insert(algorithm).second) {
+                std::cerr << "Algorithm " << algorithm << " is configured more than once, "
+                          << "its runs cannot be told apart in " << filename << std::endl;
+                return false;
+            }
+        }
+        file.open(filename, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Could not open " << filename << std::endl;
+            return false;
+        }
+        ColoringDiffHeader header{};
+        std::memcpy(header.magic, ColoringDiffHeader::expected_magic, sizeof(header.magic));
+        header.version = ColoringDiffHeader::current_version;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        return file.good();
+    }
+
+    // Write the coloring changes of `algo` with `b` matchings after `delta`, see `AlgorithmBase::get_coloring_changes`.
+    // Vertex ids are mapped to those in the input file, see `AlgorithmBase::original_id`.
+    // Colors from `colors` on are treated as uncolored, which restricts nested solutions to the first `b` colors.
+    void add_delta(const AlgorithmBase &algo, int b, int delta, color_t colors = UNCOLORED) {
+        const auto algorithm = algo.getName();
+        std::vector<unsigned char> records;
+        std::uint64_t num_records = 0;
+        for (const auto &change : algo.get_coloring_changes()) {
+            const auto old_color = change.old_color < colors ? change.old_color : UNCOLORED;
+            const auto new_color = change.new_color < colors ? change.new_color : UNCOLORED;
+            if (old_color == new_color) {
+                continue;
+            }
+            append_varint(records, algo.original_id(change.tail));
+            append_varint(records, algo.original_id(change.head));
+            append_varint(records, encode_color(old_color));
+            append_varint(records, encode_color(new_color));
+            num_records++;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        block.clear();
+        auto [run, inserted] = runs.try_emplace({algorithm, b}, runs.size());
+        if (inserted) {
+            append_varint(block, static_cast<std::uint64_t>(ColoringDiffBlock::RUN));
+            append_varint(block, b);
+            append_varint(block, algorithm.size());
+            block.insert(block.end(), algorithm.begin(), algorithm.end());
+        }
+        append_varint(block, static_cast<std::uint64_t>(ColoringDiffBlock::DELTA));
+        append_varint(block, run->second);
+        append_varint(block, delta);
+        append_varint(block, num_records);
+        file.write(reinterpret_cast<const char*>(block.data()), block.size());
+        file.write(reinterpret_cast<const char*>(records.data()), records.size());
+    }
+
+    // Flush and close the file. Returns `false` if writing failed.
+    bool close() {
+        file.close();
+        return !file.fail();
+    }
+
+private:
+    static std::uint64_t encode_color(color_t color) {
+        return color == UNCOLORED ? 0 : static_cast<std::uint64_t>(color) + 1;
+    }
+
+    std::mutex mutex;
+    std::ofstream file;
+    std::map<std::pair<std::string, int>, std::uint64_t> runs;
+    std::vector<unsigned char> block;
+};
+
+inline bool is_coloring_diff(const std::string &filename) {
+    auto file = open_input(filename);
+    char magic[sizeof(ColoringDiffHeader::expected_magic)];
+    return file && file->read(magic, sizeof(magic)) &&
+           std::memcmp(magic, ColoringDiffHeader::expected_magic, sizeof(magic)) == 0;
+}
+
+// Decode the file `filename` and call `visit` with the run, the delta and the records of each delta block.
+// Returns `false` if the file cannot be read or is malformed.
+inline bool read_coloring_diffs(const std::string &filename,
+                                const std::function<void(const ColoringDiffRun&, std::uint64_t,
+                                                         const std::vector<ColoringDiffRecord>&)> &visit) {
+    std::string data;
+    auto file = open_input(filename);
+    if (file) {
+        read_all(*file, data);
+    }
+    if (!file || decompression_failed(file.get())) {
+        std::cerr << "Could not read " << filename << std::endl;
+        return false;
+    }
+    ColoringDiffHeader header;
+    if (data.size() < sizeof(header)) {
+        std::cerr << filename << " is not a coloring diff" << std::endl;
+        return false;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (std::memcmp(header.magic, ColoringDiffHeader::expected_magic, sizeof(header.magic)) != 0
+            || header.version != ColoringDiffHeader::current_version) {
+        std::cerr << filename << " is not a coloring diff of version " << ColoringDiffHeader::current_version << std::endl;
+        return false;
+    }
+
+    const auto *pos = reinterpret_cast<const unsigned char*>(data.data()) + sizeof(header);
+    const auto *end = reinterpret_cast<const unsigned char*>(data.data()) + data.size();
+    auto next = [&pos, end](std::uint64_t &value) { return read_varint(pos, end, value); };
+
+    std::vector<ColoringDiffRun> runs;
+    std::vector<ColoringDiffRecord> records;
+    bool truncated = false;
+    while (pos < end && !truncated) {
+        std::uint64_t type;
+        if (!next(type)) {
+            truncated = true;
+        } else if (type == static_cast<std::uint64_t>(ColoringDiffBlock::RUN)) {
+            std::uint64_t b, length;
+            if (!next(b) || !next(length) || static_cast<std::uint64_t>(end - pos) < length) {
+                truncated = true;
+                break;
+            }
+            runs.push_back({std::string(reinterpret_cast<const char*>(pos), length), static_cast<int>(b)});
+            pos += length;
+        } else if (type == static_cast<std::uint64_t>(ColoringDiffBlock::DELTA)) {
+            std::uint64_t run, delta, count;
+            if (!next(run) || !next(delta) || !next(count)) {
+                truncated = true;
+                break;
+            }
+            if (run >= runs.size()) {
+                std::cerr << filename << " refers to unknown runs" << std::endl;
+                return false;
+            }
+            // Every varint takes at least one byte, so the remaining input bounds the count
+            if (static_cast<std::uint64_t>(end - pos) / 4 < count) {
+                truncated = true;
+                break;
+            }
+            records.clear();
+            for (std::uint64_t i = 0; i < count; i++) {
+                std::uint64_t tail, head, old_color, new_color;
+                if (!next(tail) || !next(head) || !next(old_color) || !next(new_color)) {
+                    truncated = true;
+                    break;
+                }
+                records.push_back({tail, head,
+                                   old_color == 0 ? UNCOLORED : static_cast<color_t>(old_color - 1),
+                                   new_color == 0 ? UNCOLORED : static_cast<color_t>(new_color - 1)});
+            }
+            if (!truncated) {
+                visit(runs[run], delta, records);
+            }
+        } else {
+            std::cerr << filename << " contains unknown blocks" << std::endl;
+            return false;
+        }
+    }
+    if (truncated || pos != end) {
+        std::cerr << filename << " is truncated" << std::endl;
+        return false;
+    }
+    return true;
+}
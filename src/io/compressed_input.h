@@ -0,0 +1,386 @@
+/**
+ * Copyright (C) 2022-2023 : Kathrin Hanauer, Lara Ost
+ *
+ * This file is part of DyDJ Match.
+ *
+ * DyDJ Match is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DyDJ Match is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DyDJ Match.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact information:
+ *   https://github.com/DJ-Match/DyDJ-Match
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+enum class Compression {NONE, GZIP, ZSTD};
+
+// Determine the compression of `filename` from its extension.
+inline Compression compression_of(const std::string &filename) {
+    auto ends_with = [&filename](const std::string &suffix) {
+        return filename.size() >= suffix.size() &&
+               filename.compare(filename.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+    if (ends_with(".gz")) {
+        return Compression::GZIP;
+    }
+    if (ends_with(".zst")) {
+        return Compression::ZSTD;
+    }
+    return Compression::NONE;
+}
+
+// Whether this build is able to read files with the given compression.
+inline bool compression_supported(Compression compression) {
+    switch (compression) {
+    case Compression::NONE:
+        return true;
+    case Compression::GZIP:
+#ifdef HAVE_ZLIB
+        return true;
+#else
+        return false;
+#endif
+    case Compression::ZSTD:
+#ifdef HAVE_ZSTD
+        return true;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+// Stream buffer that decompresses a file on a background thread.
+// The decompressed data is handed over in blocks through a bounded queue,
+// so decompression overlaps with parsing while memory usage stays constant.
+class DecompressingStreamBuf : public std::streambuf {
+
+public:
+    static constexpr std::size_t block_size = 1 << 20;
+    static constexpr std::size_t max_queued_blocks = 4;
+
+    DecompressingStreamBuf() = default;
+    DecompressingStreamBuf(const DecompressingStreamBuf&) = delete;
+    DecompressingStreamBuf& operator=(const DecompressingStreamBuf&) = delete;
+
+    ~DecompressingStreamBuf() {
+        close();
+    }
+
+    bool open(const std::string &filename, Compression compression) {
+        close();
+        if (!compression_supported(compression) || compression == Compression::NONE) {
+            return false;
+        }
+        file = std::fopen(filename.c_str(), "rb");
+        if (file == nullptr) {
+            return false;
+        }
+        finished = false;
+        stopped = false;
+        error = false;
+        busy_seconds = 0;
+        producer = std::thread(&DecompressingStreamBuf::produce, this, compression);
+        return true;
+    }
+
+    void close() {
+        if (producer.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopped = true;
+            }
+            not_full.notify_all();
+            producer.join();
+        }
+        if (file != nullptr) {
+            std::fclose(file);
+            file = nullptr;
+        }
+        blocks.clear();
+        current.clear();
+        setg(nullptr, nullptr, nullptr);
+    }
+
+    // Whether the compressed data turned out to be corrupt.
+    bool failed() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return error;
+    }
+
+    // Time the background thread spent decompressing so far, excluding waiting for the consumer.
+    double decompression_time() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return busy_seconds;
+    }
+
+protected:
+    virtual int_type underflow() override {
+        if (gptr() < egptr()) {
+            return traits_type::to_int_type(*gptr());
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        not_empty.wait(lock, [this]() { return !blocks.empty() || finished; });
+        if (blocks.empty()) {
+            return traits_type::eof();
+        }
+        current.swap(blocks.front());
+        blocks.pop_front();
+        lock.unlock();
+        not_full.notify_one();
+        setg(current.data(), current.data(), current.data() + current.size());
+        return traits_type::to_int_type(*gptr());
+    }
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    // Hand a decompressed block to the consumer. Returns `false` if reading was stopped.
+    bool push(std::vector<char> &&block) {
+        std::unique_lock<std::mutex> lock(mutex);
+        not_full.wait(lock, [this]() { return blocks.size() < max_queued_blocks || stopped; });
+        if (stopped) {
+            return false;
+        }
+        blocks.push_back(std::move(block));
+        lock.unlock();
+        not_empty.notify_one();
+        return true;
+    }
+
+    void finish(bool failure, double seconds) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finished = true;
+            error = failure;
+            busy_seconds += seconds;
+        }
+        not_empty.notify_all();
+    }
+
+    void add_busy_time(clock::time_point start) {
+        std::lock_guard<std::mutex> lock(mutex);
+        busy_seconds += std::chrono::duration<double>(clock::now() - start).count();
+    }
+
+    void produce(Compression compression) {
+        bool failure = false;
+        if (compression == Compression::GZIP) {
+            failure = !produce_gzip();
+        } else if (compression == Compression::ZSTD) {
+            failure = !produce_zstd();
+        }
+        finish(failure, 0);
+    }
+
+    bool produce_gzip() {
+#ifdef HAVE_ZLIB
+        // zlib takes over the file descriptor; the FILE handle is closed in `close()`.
+        gzFile gz = gzdopen(dup(fileno(file)), "rb");
+        if (gz == nullptr) {
+            return false;
+        }
+        gzbuffer(gz, 1 << 17);
+        bool ok = true;
+        while (true) {
+            auto start = clock::now();
+            std::vector<char> block(block_size);
+            int read = gzread(gz, block.data(), static_cast<unsigned>(block.size()));
+            add_busy_time(start);
+            if (read < 0) {
+                ok = false;
+                break;
+            }
+            if (read == 0) {
+                break;
+            }
+            block.resize(static_cast<std::size_t>(read));
+            if (!push(std::move(block))) {
+                break;
+            }
+        }
+        gzclose(gz);
+        return ok;
+#else
+        return false;
+#endif
+    }
+
+    bool produce_zstd() {
+#ifdef HAVE_ZSTD
+        ZSTD_DStream *zstream = ZSTD_createDStream();
+        ZSTD_initDStream(zstream);
+        std::vector<char> input(ZSTD_DStreamInSize());
+        std::vector<char> block(block_size);
+        std::size_t block_fill = 0;
+        std::size_t last_result = 0;
+        bool ok = true;
+        bool reading = true;
+        while (reading) {
+            auto start = clock::now();
+            std::size_t read = std::fread(input.data(), 1, input.size(), file);
+            if (read == 0) {
+                // Input that ends inside a frame is truncated.
+                ok = !std::ferror(file) && last_result == 0;
+                add_busy_time(start);
+                break;
+            }
+            ZSTD_inBuffer in{input.data(), read, 0};
+            while (in.pos < in.size) {
+                ZSTD_outBuffer out{block.data() + block_fill, block.size() - block_fill, 0};
+                last_result = ZSTD_decompressStream(zstream, &out, &in);
+                if (ZSTD_isError(last_result)) {
+                    ok = false;
+                    reading = false;
+                    break;
+                }
+                block_fill += out.pos;
+                if (block_fill == block.size()) {
+                    add_busy_time(start);
+                    if (!push(std::move(block))) {
+                        reading = false;
+                        break;
+                    }
+                    block = std::vector<char>(block_size);
+                    block_fill = 0;
+                    start = clock::now();
+                }
+            }
+            if (reading) {
+                add_busy_time(start);
+            }
+        }
+        if (ok && block_fill > 0) {
+            block.resize(block_fill);
+            push(std::move(block));
+        }
+        ZSTD_freeDStream(zstream);
+        return ok;
+#else
+        return false;
+#endif
+    }
+
+    std::FILE *file = nullptr;
+    std::thread producer;
+
+    mutable std::mutex mutex;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+    std::deque<std::vector<char>> blocks;
+    bool finished = false;
+    bool stopped = false;
+    bool error = false;
+    double busy_seconds = 0;
+
+    // Block currently read by the consumer
+    std::vector<char> current;
+};
+
+// Input stream over a compressed file, see `DecompressingStreamBuf`.
+class DecompressingIStream : public std::istream {
+
+public:
+    DecompressingIStream() : std::istream(nullptr) {
+        rdbuf(&buffer);
+    }
+
+    bool open(const std::string &filename, Compression compression) {
+        clear();
+        if (!buffer.open(filename, compression)) {
+            setstate(std::ios::failbit);
+            return false;
+        }
+        return true;
+    }
+
+    bool failed() const {
+        return buffer.failed();
+    }
+
+    double decompression_time() const {
+        return buffer.decompression_time();
+    }
+
+private:
+    DecompressingStreamBuf buffer;
+};
+
+// Open `filename` for reading, decompressing it on a background thread if it ends in `.gz` or `.zst`.
+// Returns `nullptr` if the file cannot be opened or its compression is not supported by this build.
+inline std::unique_ptr<std::istream> open_input(const std::string &filename) {
+    const auto compression = compression_of(filename);
+    if (compression == Compression::NONE) {
+        auto stream = std::make_unique<std::ifstream>(filename);
+        if (!stream->is_open()) {
+            return nullptr;
+        }
+        return stream;
+    }
+    if (!compression_supported(compression)) {
+        std::cerr << "This build cannot read " << filename
+                  << "; recompile with " << (compression == Compression::GZIP ? "zlib" : "zstd")
+                  << " available" << std::endl;
+        return nullptr;
+    }
+    auto stream = std::make_unique<DecompressingIStream>();
+    if (!stream->open(filename, compression)) {
+        return nullptr;
+    }
+    return stream;
+}
+
+// Read the remainder of `stream` into `content`.
+inline void read_all(std::istream &stream, std::string &content) {
+    content.clear();
+    std::vector<char> chunk(DecompressingStreamBuf::block_size);
+    std::streamsize read;
+    while ((read = stream.rdbuf()->sgetn(chunk.data(), static_cast<std::streamsize>(chunk.size()))) > 0) {
+        content.append(chunk.data(), static_cast<std::size_t>(read));
+    }
+}
+
+// Whether decompressing `stream` failed because of corrupt data.
+inline bool decompression_failed(const std::istream *stream) {
+    auto decompressing = dynamic_cast<const DecompressingIStream*>(stream);
+    return decompressing != nullptr && decompressing->failed();
+}
+
+// Time spent decompressing `stream` so far, or 0 if it is not compressed.
+inline double decompression_time(const std::istream *stream) {
+    auto decompressing = dynamic_cast<const DecompressingIStream*>(stream);
+    return decompressing != nullptr ? decompressing->decompression_time() : 0;
+}
@@ -0,0 +1,95 @@
+/**
+ * Copyright (C) 2022-2023 : Kathrin Hanauer, Lara Ost
+ *
+ * This file is part of DyDJ Match.
+ *
+ * DyDJ Match is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DyDJ Match is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DyDJ Match.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact information:
+ *   https://github.com/DJ-Match/DyDJ-Match
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "io/trace_update.h"
+
+// Collapses the updates of a delta such that each arc changes at most once.
+// Within a delta, an arc may receive several updates, each of which would otherwise be
+// propagated to every algorithm. Only the arc's final weight matters for the next solution,
+// so its updates are replaced by a single one, and dropped entirely if the final weight
+// equals the weight before the delta.
+class DeltaCoalescer {
+
+public:
+    // Coalesce `delta` in place. `weight_of(key)` must return the weight of the arc `key`
+    // before the delta, or 0 if it is not present. Each remaining update takes the position
+    // of the first update of its arc.
+    template<typename WeightF>
+    void coalesce(std::vector<TraceUpdate> &delta, WeightF weight_of) {
+        total += delta.size();
+        positions.clear();
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < delta.size(); i++) {
+            const TraceArcKey key(delta[i].tail, delta[i].head);
+            auto [it, inserted] = positions.try_emplace(key, kept);
+            if (inserted) {
+                delta[kept++] = delta[i];
+            } else {
+                delta[it->second].weight = delta[i].weight;
+            }
+        }
+        delta.resize(kept);
+
+        kept = 0;
+        for (std::size_t i = 0; i < delta.size(); i++) {
+            const long long old_weight = weight_of(TraceArcKey(delta[i].tail, delta[i].head));
+            const long long new_weight = delta[i].weight > 0 ? delta[i].weight : 0;
+            if (old_weight != new_weight) {
+                delta[kept++] = delta[i];
+            }
+        }
+        delta.resize(kept);
+        remaining += kept;
+    }
+
+    // Number of updates passed to `coalesce` and number of updates left afterwards.
+    std::uint64_t total_updates() const {
+        return total;
+    }
+
+    std::uint64_t remaining_updates() const {
+        return remaining;
+    }
+
+    // Include the counts of `other`, e.g., of another thread.
+    void add(const DeltaCoalescer &other) {
+        add(other.total, other.remaining);
+    }
+
+    // Include counts reported by another process.
+    void add(std::uint64_t total_updates, std::uint64_t remaining_updates) {
+        total += total_updates;
+        remaining += remaining_updates;
+    }
+
+private:
+    std::unordered_map<TraceArcKey, std::size_t, TraceArcKeyHash> positions;
+    std::uint64_t total = 0;
+    std::uint64_t remaining = 0;
+};
@@ -0,0 +1,199 @@
+/**
+ * Copyright (C) 2022-2023 : Kathrin Hanauer, Lara Ost
+ *
+ * This file is part of DyDJ Match.
+ *
+ * DyDJ Match is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DyDJ Match is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DyDJ Match.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact information:
+ *   https://github.com/DJ-Match/DyDJ-Match
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "io/mapped_file.h"
+#include "io/parallel_konect_parser.h"
+
+// Position of the first line of a delta in a Konect edge list.
+struct DeltaIndexEntry {
+    std::uint64_t timestamp;
+    std::uint64_t offset;
+    std::uint64_t line;
+};
+
+// Index of the deltas of an uncompressed, timestamp-sorted Konect edge list that maps
+// delta numbers and timestamps to byte offsets. The index is persisted next to the
+// trace as `<trace>.idx` and rebuilt whenever the trace has been modified.
+class DeltaIndex {
+
+public:
+    static std::string index_filename(const std::string &trace_filename) {
+        return trace_filename + ".idx";
+    }
+
+    // Load the persisted index of `trace_filename` if it is up to date; otherwise,
+    // build it and try to persist it.
+    bool load_or_build(const std::string &trace_filename) {
+        if (load(trace_filename)) {
+            return true;
+        }
+        if (!build(trace_filename)) {
+            return false;
+        }
+        if (!save(trace_filename)) {
+            std::cerr << "Could not write " << index_filename(trace_filename)
+                      << ", the index of the deltas will be rebuilt on the next run" << std::endl;
+        }
+        return true;
+    }
+
+    // Scan `trace_filename` for the first line of each delta.
+    bool build(const std::string &trace_filename) {
+        using namespace konect_scan_detail;
+
+        entries.clear();
+        if (!stat_trace(trace_filename)) {
+            return false;
+        }
+        MappedFile file;
+        if (!file.open(trace_filename)) {
+            std::cerr << "Could not open file " << trace_filename << std::endl;
+            return false;
+        }
+        file.advise_sequential();
+        const char *begin = reinterpret_cast<const char*>(file.data());
+        const char *end = begin + file.size();
+        std::uint64_t line = 0;
+        for (const char *pos = begin; pos != end; ) {
+            const char *line_start = pos;
+            line++;
+            skip_blanks(pos, end);
+            if (pos == end || *pos == '\n' || *pos == '%') {
+                skip_line(pos, end);
+                continue;
+            }
+            unsigned long long vertex, timestamp;
+            long long weight;
+            if (!scan_unsigned(pos, end, vertex) || !scan_unsigned(pos, end, vertex)
+                    || !scan_signed(pos, end, weight) || !scan_unsigned(pos, end, timestamp)) {
+                std::cerr << "Malformed line " << line << " in " << trace_filename << std::endl;
+                return false;
+            }
+            if (entries.empty() || entries.back().timestamp != timestamp) {
+                if (!entries.empty() && timestamp < entries.back().timestamp) {
+                    std::cerr << "Line " << line << " of " << trace_filename
+                              << " is not sorted by timestamp" << std::endl;
+                    return false;
+                }
+                entries.push_back({timestamp, static_cast<std::uint64_t>(line_start - begin), line});
+            }
+            skip_line(pos, end);
+        }
+        return true;
+    }
+
+    // Load the persisted index; fails if there is none or it is outdated.
+    bool load(const std::string &trace_filename) {
+        entries.clear();
+        if (!stat_trace(trace_filename)) {
+            return false;
+        }
+        std::ifstream file(index_filename(trace_filename), std::ios::binary);
+        IndexHeader header;
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+                std::memcmp(header.magic, expected_magic, sizeof(header.magic)) != 0 ||
+                header.trace_size != trace_size || header.trace_mtime != trace_mtime) {
+            return false;
+        }
+        entries.resize(header.num_deltas);
+        if (!file.read(reinterpret_cast<char*>(entries.data()), entries.size() * sizeof(DeltaIndexEntry))) {
+            entries.clear();
+            return false;
+        }
+        return true;
+    }
+
+    // Write the index to a temporary file first and rename it, so that concurrent runs
+    // never read a partially written index.
+    bool save(const std::string &trace_filename) const {
+        const auto filename = index_filename(trace_filename);
+        const auto temp_filename = filename + ".tmp" + std::to_string(getpid());
+        std::ofstream file(temp_filename, std::ios::binary | std::ios::trunc);
+        IndexHeader header;
+        std::memcpy(header.magic, expected_magic, sizeof(header.magic));
+        header.trace_size = trace_size;
+        header.trace_mtime = trace_mtime;
+        header.num_deltas = entries.size();
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(DeltaIndexEntry));
+        file.close();
+        if (file.fail() || std::rename(temp_filename.c_str(), filename.c_str()) != 0) {
+            std::remove(temp_filename.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    std::size_t num_deltas() const {
+        return entries.size();
+    }
+
+    const DeltaIndexEntry& operator[](std::size_t delta) const {
+        return entries[delta];
+    }
+
+    // Number of the first delta with a timestamp of at least `timestamp`, or `num_deltas()` if there is none.
+    std::size_t find_delta(std::uint64_t timestamp) const {
+        return std::lower_bound(entries.begin(), entries.end(), timestamp,
+                                [](const DeltaIndexEntry &entry, std::uint64_t value) {
+            return entry.timestamp < value;
+        }) - entries.begin();
+    }
+
+private:
+    static constexpr char expected_magic[8] = {'D', 'Y', 'D', 'J', 'I', 'D', 'X', '\0'};
+
+    struct IndexHeader {
+        char magic[8];
+        std::uint64_t trace_size;
+        std::uint64_t trace_mtime;
+        std::uint64_t num_deltas;
+    };
+
+    bool stat_trace(const std::string &trace_filename) {
+        struct stat trace_stat;
+        if (stat(trace_filename.c_str(), &trace_stat) != 0) {
+            return false;
+        }
+        trace_size = static_cast<std::uint64_t>(trace_stat.st_size);
+        trace_mtime = static_cast<std::uint64_t>(trace_stat.st_mtime);
+        return true;
+    }
+
+    std::vector<DeltaIndexEntry> entries;
+    std::uint64_t trace_size = 0;
+    std::uint64_t trace_mtime = 0;
+};
@@ -0,0 +1,370 @@
+/**
+ * Copyright (C) 2022-2023 : Kathrin Hanauer, Lara Ost
+ *
+ * This file is part of DyDJ Match.
+ *
+ * DyDJ Match is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DyDJ Match is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DyDJ Match.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact information:
+ *   https://github.com/DJ-Match/DyDJ-Match
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "io/binary_trace.h"
+#include "io/compressed_input.h"
+#include "io/delta_index.h"
+#include "io/parallel_konect_parser.h"
+#include "io/trace_update.h"
+#include "io/update_log.h"
+
+// Sequential source of deltas, i.e., of maximal groups of updates with identical timestamp.
+// Only a single delta is held in memory at a time.
+class DeltaSource {
+
+public:
+    virtual ~DeltaSource() = default;
+
+    // (Re-)start reading at the first delta of the trace.
+    virtual bool rewind() = 0;
+
+    // Read the next delta into `delta`, replacing its contents.
+    // Returns `false` at the end of the trace or if an error occurred, see `failed()`.
+    virtual bool next_delta(std::vector<TraceUpdate> &delta) = 0;
+
+    // Position the source such that the next call to `next_delta` returns the delta
+    // with number `delta`, counting from 0. By default, all earlier deltas are skipped.
+    virtual bool seek(std::size_t delta) {
+        if (!rewind()) {
+            return false;
+        }
+        std::vector<TraceUpdate> skipped;
+        for (std::size_t i = 0; i < delta && next_delta(skipped); i++) {
+        }
+        return !error;
+    }
+
+    // Number of the first delta with a timestamp of at least `timestamp`.
+    // By default, the deltas are read from the beginning until it is found.
+    virtual std::size_t find_delta(TraceUpdate::timestamp_type timestamp) {
+        std::size_t count = 0;
+        std::vector<TraceUpdate> delta;
+        if (rewind()) {
+            while (next_delta(delta) && delta.front().timestamp < timestamp) {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    bool failed() const {
+        return error;
+    }
+
+    // Total time spent decompressing the input, over all passes.
+    virtual double decompression_time() const {
+        return 0;
+    }
+
+protected:
+    bool error = false;
+};
+
+// Streams deltas from a Konect edge list, which may be compressed, see `open_input`.
+// Lines have to be sorted by timestamp, as the file is never held in memory as a whole.
+// With the `index` of an uncompressed file, see `load_delta_index`, deltas are skipped by seeking.
+class KonectDeltaSource : public DeltaSource {
+
+public:
+    explicit KonectDeltaSource(const std::string &filename, std::shared_ptr<const DeltaIndex> index = nullptr)
+        : filename(filename), index(std::move(index)) {}
+
+    virtual bool rewind() override {
+        finish_pass();
+        file = open_input(filename);
+        error = !file;
+        if (error) {
+            std::cerr << "Could not open file " << filename << std::endl;
+        }
+        line_number = 0;
+        pending.clear();
+        return !error;
+    }
+
+    virtual bool next_delta(std::vector<TraceUpdate> &delta) override {
+        delta.clear();
+        if (error) {
+            return false;
+        }
+        if (pending.empty() && !read_update()) {
+            return false;
+        }
+        delta.push_back(pending.front());
+        while (read_update()) {
+            if (pending.front().timestamp != delta.front().timestamp) {
+                if (pending.front().timestamp < delta.front().timestamp) {
+                    std::cerr << "Line " << line_number << " of " << filename
+                              << " is not sorted by timestamp" << std::endl;
+                    error = true;
+                    delta.clear();
+                    return false;
+                }
+                return true;
+            }
+            delta.push_back(pending.front());
+        }
+        return !error;
+    }
+
+    virtual double decompression_time() const override {
+        return previous_decompression_time + ::decompression_time(file.get());
+    }
+
+    virtual bool seek(std::size_t delta) override {
+        if (!index) {
+            return DeltaSource::seek(delta);
+        }
+        if (!rewind()) {
+            return false;
+        }
+        if (delta < index->num_deltas()) {
+            file->seekg((*index)[delta].offset);
+            line_number = (*index)[delta].line - 1;
+        } else {
+            file->seekg(0, std::ios::end);
+        }
+        return true;
+    }
+
+    virtual std::size_t find_delta(TraceUpdate::timestamp_type timestamp) override {
+        if (!index) {
+            return DeltaSource::find_delta(timestamp);
+        }
+        return index->find_delta(timestamp);
+    }
+
+private:
+
+    void finish_pass() {
+        previous_decompression_time += ::decompression_time(file.get());
+        file.reset();
+    }
+
+    // Parse the next update into `pending`, skipping empty and comment lines.
+    bool read_update() {
+        pending.clear();
+        while (pending.empty() && std::getline(*file, line)) {
+            line_number++;
+            if (konect_scan_detail::parse_chunk(line.data(), line.data() + line.size(), pending) != line.size()) {
+                std::cerr << "Malformed line " << line_number << ": '" << line << "'" << std::endl;
+                error = true;
+                return false;
+            }
+        }
+        if (pending.empty() && decompression_failed(file.get())) {
+            std::cerr << "Could not decompress " << filename << std::endl;
+            error = true;
+        }
+        return !pending.empty();
+    }
+
+    std::string filename;
+    std::shared_ptr<const DeltaIndex> index;
+    std::unique_ptr<std::istream> file;
+    double previous_decompression_time = 0;
+    std::string line;
+    unsigned long long line_number = 0;
+    // Holds the first update of the next delta once it has been read.
+    std::vector<TraceUpdate> pending;
+};
+
+// Streams deltas from a memory-mapped binary trace.
+class BinaryDeltaSource : public DeltaSource {
+
+public:
+    explicit BinaryDeltaSource(const std::string &filename) : filename(filename) {}
+
+    virtual bool rewind() override {
+        if (!reader.is_open()) {
+            error = !reader.open(filename);
+        }
+        next = 0;
+        timestamp = 0;
+        return !error;
+    }
+
+    virtual bool next_delta(std::vector<TraceUpdate> &delta) override {
+        if (error || next >= reader.num_deltas()) {
+            delta.clear();
+            return false;
+        }
+        if (!reader.read_delta(next++, timestamp, delta)) {
+            std::cerr << filename << " contains a malformed delta" << std::endl;
+            error = true;
+            delta.clear();
+            return false;
+        }
+        return true;
+    }
+
+    virtual bool seek(std::size_t delta) override {
+        if (!rewind()) {
+            return false;
+        }
+        if (!load_timestamps()) {
+            return false;
+        }
+        next = std::min<std::size_t>(delta, timestamps.size());
+        timestamp = next > 0 ? timestamps[next - 1] : 0;
+        return true;
+    }
+
+    virtual std::size_t find_delta(TraceUpdate::timestamp_type value) override {
+        if (!rewind() || !load_timestamps()) {
+            return 0;
+        }
+        return std::lower_bound(timestamps.begin(), timestamps.end(), value) - timestamps.begin();
+    }
+
+private:
+    bool load_timestamps() {
+        if (timestamps.empty() && !reader.delta_timestamps(timestamps)) {
+            std::cerr << filename << " contains a malformed delta" << std::endl;
+            timestamps.clear();
+            error = true;
+        }
+        return !error;
+    }
+
+    std::string filename;
+    BinaryTraceReader reader;
+    std::uint64_t next = 0;
+    TraceUpdate::timestamp_type timestamp = 0;
+    // Timestamp of each delta, decoded on demand
+    std::vector<TraceUpdate::timestamp_type> timestamps;
+};
+
+// Replays the deltas of an in-memory `UpdateLog`.
+class LogDeltaSource : public DeltaSource {
+
+public:
+    explicit LogDeltaSource(std::shared_ptr<const UpdateLog> log) : log(std::move(log)) {}
+
+    virtual bool rewind() override {
+        next = 0;
+        return true;
+    }
+
+    virtual bool next_delta(std::vector<TraceUpdate> &delta) override {
+        if (next >= log->num_deltas()) {
+            delta.clear();
+            return false;
+        }
+        delta.assign(log->delta_begin(next), log->delta_end(next));
+        next++;
+        return true;
+    }
+
+    virtual bool seek(std::size_t delta) override {
+        next = std::min(delta, log->num_deltas());
+        return true;
+    }
+
+    virtual std::size_t find_delta(TraceUpdate::timestamp_type timestamp) override {
+        return log->find_delta(timestamp);
+    }
+
+private:
+    std::shared_ptr<const UpdateLog> log;
+    std::size_t next = 0;
+};
+
+// Create a delta source for `filename`, which is either a binary trace or a Konect edge list.
+inline std::unique_ptr<DeltaSource> make_delta_source(const std::string &filename,
+                                                      std::shared_ptr<const DeltaIndex> index = nullptr) {
+    if (BinaryTraceReader::is_binary_trace(filename)) {
+        return std::make_unique<BinaryDeltaSource>(filename);
+    }
+    return std::make_unique<KonectDeltaSource>(filename, std::move(index));
+}
+
+// Load or build the `DeltaIndex` of `filename`, which can be shared by all its `KonectDeltaSource`s.
+// Returns `nullptr` if `filename` is compressed or a binary trace, which need no index, or if building it failed.
+inline std::shared_ptr<const DeltaIndex> load_delta_index(const std::string &filename) {
+    if (BinaryTraceReader::is_binary_trace(filename) || compression_of(filename) != Compression::NONE) {
+        return nullptr;
+    }
+    auto index = std::make_shared<DeltaIndex>();
+    if (!index->load_or_build(filename)) {
+        return nullptr;
+    }
+    return index;
+}
+
+// Read the first `count` deltas of `source` and fold them into the resulting graph state:
+// `state` receives one update per arc present after these deltas, with its final weight,
+// in the order of the arcs' (last) insertion. If the trace has fewer deltas, `count` is
+// reduced accordingly.
+inline bool aggregate_deltas(DeltaSource &source, std::size_t &count, std::vector<TraceUpdate> &state) {
+    std::unordered_map<TraceArcKey, std::size_t, TraceArcKeyHash> positions;
+
+    state.clear();
+    if (!source.rewind()) {
+        return false;
+    }
+    std::vector<TraceUpdate> delta;
+    TraceUpdate::timestamp_type last_timestamp = 0;
+    std::size_t aggregated = 0;
+    for (; aggregated < count && source.next_delta(delta); aggregated++) {
+        last_timestamp = delta.front().timestamp;
+        for (const auto &update : delta) {
+            const TraceArcKey key(update.tail, update.head);
+            if (update.weight > 0) {
+                auto [it, inserted] = positions.try_emplace(key, state.size());
+                if (inserted) {
+                    state.push_back(update);
+                } else {
+                    state[it->second].weight = update.weight;
+                }
+            } else {
+                auto it = positions.find(key);
+                if (it != positions.end()) {
+                    // leave a tombstone, removed below
+                    state[it->second].weight = 0;
+                    positions.erase(it);
+                }
+            }
+        }
+    }
+    if (source.failed()) {
+        return false;
+    }
+    count = aggregated;
+    state.erase(std::remove_if(state.begin(), state.end(), [](const TraceUpdate &update) {
+        return update.weight <= 0;
+    }), state.end());
+    for (auto &update : state) {
+        update.timestamp = last_timestamp;
+    }
+    return true;
+}
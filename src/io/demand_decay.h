@@ -0,0 +1,117 @@
+/**
+ * Copyright (C) 2022-2023 : Kathrin Hanauer, Lara Ost
+ *
+ * This file is part of DyDJ Match.
+ *
+ * DyDJ Match is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DyDJ Match is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DyDJ Match.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact information:
+ *   https://github.com/DJ-Match/DyDJ-Match
+ */
+
+
+#pragma once
+
+#include <cmath>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "io/trace_update.h"
+
+// Turns the per-timestamp demands of a trace into exponentially decayed demands.
+// The decayed demand of an arc at time `t` is the sum of its demands `w_i` at times `t_i <= t`,
+// each weighted by `2^(-(t - t_i) / half_life)`.
+// Since all arcs decay by the same factor, weights are kept relative to an epoch `t_0`, i.e., scaled
+// by `2^((t - t_0) / half_life)`. Their order, and thus every comparison made by the algorithms, is
+// unaffected by the passage of time, so only arcs that receive demand are updated. Once the scale
+// factor gets too large, all weights are rescaled to a new epoch, removing arcs whose decayed demand
+// has dropped below one unit.
+class DemandDecay {
+
+public:
+    // Number of half-lives after which weights are rescaled to a new epoch
+    static constexpr double max_epoch_length = 16;
+
+    explicit DemandDecay(double half_life) : half_life(half_life) {}
+
+    // Forget all demands, e.g., when replaying the trace on a new graph.
+    void reset() {
+        scaled_demands.clear();
+        epoch.reset();
+        now = 0;
+    }
+
+    // Replace the demands in `delta` by updates that set the scaled decayed demands.
+    // A rescaling to a new epoch is prepended to the delta if necessary.
+    void apply(std::vector<TraceUpdate> &delta) {
+        if (delta.empty()) {
+            return;
+        }
+        if (!epoch) {
+            epoch = delta.front().timestamp;
+        }
+        scaled_delta.clear();
+        if (half_lives_since_epoch(delta.front().timestamp) > max_epoch_length) {
+            start_epoch(delta.front().timestamp);
+        }
+        for (const auto &update : delta) {
+            if (update.weight <= 0) {
+                // no demand, the arc just keeps decaying
+                continue;
+            }
+            auto &demand = scaled_demands[TraceArcKey(update.tail, update.head)];
+            demand += std::llround(update.weight * scale(update.timestamp));
+            scaled_delta.push_back({update.tail, update.head, demand, update.timestamp});
+        }
+        now = delta.back().timestamp;
+        std::swap(delta, scaled_delta);
+    }
+
+    // Convert a scaled weight, e.g., of a solution, to the decayed demand as of the last delta.
+    template<typename T>
+    T decayed(T scaled_weight) const {
+        return epoch ? static_cast<T>(std::llround(scaled_weight / scale(now))) : scaled_weight;
+    }
+
+private:
+    double half_lives_since_epoch(TraceUpdate::timestamp_type timestamp) const {
+        return (static_cast<double>(timestamp) - static_cast<double>(*epoch)) / half_life;
+    }
+
+    double scale(TraceUpdate::timestamp_type timestamp) const {
+        return std::exp2(half_lives_since_epoch(timestamp));
+    }
+
+    void start_epoch(TraceUpdate::timestamp_type timestamp) {
+        const auto factor = scale(timestamp);
+        for (auto it = scaled_demands.begin(); it != scaled_demands.end();) {
+            it->second = std::llround(it->second / factor);
+            scaled_delta.push_back({it->first.first, it->first.second, it->second, timestamp});
+            if (it->second <= 0) {
+                it = scaled_demands.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        epoch = timestamp;
+    }
+
+    const double half_life;
+    std::optional<TraceUpdate::timestamp_type> epoch;
+    TraceUpdate::timestamp_type now = 0;
+    std::unordered_map<TraceArcKey, long long, TraceArcKeyHash> scaled_demands;
+    std::vector<TraceUpdate> scaled_delta;
+};
@@ -0,0 +1,229 @@
+/**
+ * Copyright (C) 2022-2023 : Kathrin Hanauer, Lara Ost
+ *
+ * This file is part of DyDJ Match.
+ *
+ * DyDJ Match is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DyDJ Match is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DyDJ Match.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact information:
+ *   https://github.com/DJ-Match/DyDJ-Match
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "io/compressed_input.h"
+#include "io/varint.h"
+
+// Weight change of an arc, as delivered to the `onPropertyChange` observers of the algorithms.
+struct WeightEvent {
+    std::uint64_t arc;
+    std::uint64_t old_weight;
+    std::uint64_t new_weight;
+};
+
+// Per-delta sequence of the weight changes seen by the algorithms while a trace is replayed,
+// together with the arcs they refer to. An arc is present while its weight is positive, i.e., an event
+// with old weight 0 inserts it and an event with new weight 0 removes it.
+//
+// Layout (all fixed-width integers in native byte order):
+//   header       see `EventLogHeader`
+//   arc table    `num_arcs` x (varint tail, varint head), vertices in `[0, num_vertices)`
+//   deltas       per delta: varint number of events,
+//                  per event: varint arc index, varint old weight, varint new weight
+struct EventLogHeader {
+    static constexpr char expected_magic[8] = {'D', 'Y', 'D', 'J', 'E', 'V', 'T', '\0'};
+    static constexpr std::uint32_t current_version = 1;
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t flags;
+    std::uint64_t num_vertices;
+    std::uint64_t num_arcs;
+    std::uint64_t num_deltas;
+    std::uint64_t num_events;
+};
+
+class EventLog {
+
+public:
+    // Add an arc between the vertices `tail` and `head` and return its index.
+    std::uint64_t add_arc(std::uint64_t tail, std::uint64_t head) {
+        num_vertices = std::max(num_vertices, std::max(tail, head) + 1);
+        arcs.emplace_back(tail, head);
+        return arcs.size() - 1;
+    }
+
+    void add_event(std::uint64_t arc, std::uint64_t old_weight, std::uint64_t new_weight) {
+        events.push_back({arc, old_weight, new_weight});
+    }
+
+    // Close the current delta, which consists of all events added since the previous one.
+    void end_delta() {
+        delta_ends.push_back(events.size());
+    }
+
+    std::uint64_t get_num_vertices() const {
+        return num_vertices;
+    }
+
+    const std::vector<std::pair<std::uint64_t, std::uint64_t>>& get_arcs() const {
+        return arcs;
+    }
+
+    std::size_t num_deltas() const {
+        return delta_ends.size();
+    }
+
+    std::size_t num_events() const {
+        return events.size();
+    }
+
+    // Events of the delta with number `delta`, counting from 0.
+    const WeightEvent* delta_begin(std::size_t delta) const {
+        return events.data() + (delta > 0 ? delta_ends[delta - 1] : 0);
+    }
+
+    const WeightEvent* delta_end(std::size_t delta) const {
+        return events.data() + delta_ends[delta];
+    }
+
+    bool write(std::ostream &stream) const {
+        EventLogHeader header{};
+        std::memcpy(header.magic, EventLogHeader::expected_magic, sizeof(header.magic));
+        header.version = EventLogHeader::current_version;
+        header.num_vertices = num_vertices;
+        header.num_arcs = arcs.size();
+        header.num_deltas = delta_ends.size();
+        header.num_events = events.size();
+        stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        std::vector<unsigned char> buffer;
+        for (const auto &[tail, head] : arcs) {
+            append_varint(buffer, tail);
+            append_varint(buffer, head);
+        }
+        for (std::size_t delta = 0; delta < delta_ends.size(); delta++) {
+            append_varint(buffer, delta_end(delta) - delta_begin(delta));
+            for (auto event = delta_begin(delta); event != delta_end(delta); ++event) {
+                append_varint(buffer, event->arc);
+                append_varint(buffer, event->old_weight);
+                append_varint(buffer, event->new_weight);
+            }
+            if (buffer.size() >= (1 << 20)) {
+                stream.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+                buffer.clear();
+            }
+        }
+        stream.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+        return stream.good();
+    }
+
+    // Read and decode the whole log, replacing the contents of this one.
+    bool read(const std::string &filename) {
+        std::string data;
+        auto file = open_input(filename);
+        if (file) {
+            read_all(*file, data);
+        }
+        if (!file || decompression_failed(file.get())) {
+            std::cerr << "Could not read " << filename << std::endl;
+            return false;
+        }
+        EventLogHeader header;
+        if (data.size() < sizeof(header)) {
+            std::cerr << filename << " is not an event log" << std::endl;
+            return false;
+        }
+        std::memcpy(&header, data.data(), sizeof(header));
+        if (std::memcmp(header.magic, EventLogHeader::expected_magic, sizeof(header.magic)) != 0
+                || header.version != EventLogHeader::current_version) {
+            std::cerr << filename << " is not an event log of version " << EventLogHeader::current_version << std::endl;
+            return false;
+        }
+
+        const auto *pos = reinterpret_cast<const unsigned char*>(data.data()) + sizeof(header);
+        const auto *end = reinterpret_cast<const unsigned char*>(data.data()) + data.size();
+        auto next = [&pos, end](std::uint64_t &value) { return read_varint(pos, end, value); };
+
+        arcs.clear();
+        events.clear();
+        delta_ends.clear();
+        // Check the counts before allocating for them: every varint takes at least one byte,
+        // and every vertex is the tail or head of an arc
+        const std::uint64_t size = end - pos;
+        if (header.num_arcs > size / 2 || header.num_vertices > 2 * header.num_arcs
+                || header.num_events > (size - 2 * header.num_arcs) / 3
+                || header.num_deltas > size - 2 * header.num_arcs - 3 * header.num_events) {
+            std::cerr << filename << " is truncated" << std::endl;
+            return false;
+        }
+        num_vertices = header.num_vertices;
+        bool truncated = false;
+        arcs.reserve(header.num_arcs);
+        for (std::uint64_t i = 0; i < header.num_arcs && !truncated; i++) {
+            std::uint64_t tail, head;
+            truncated = !next(tail) || !next(head);
+            arcs.emplace_back(tail, head);
+        }
+        events.reserve(header.num_events);
+        delta_ends.reserve(header.num_deltas);
+        for (std::uint64_t delta = 0; delta < header.num_deltas && !truncated; delta++) {
+            std::uint64_t count;
+            if (!next(count) || count > header.num_events - events.size()) {
+                truncated = true;
+                break;
+            }
+            for (std::uint64_t i = 0; i < count && !truncated; i++) {
+                std::uint64_t arc, old_weight, new_weight;
+                truncated = !next(arc) || !next(old_weight) || !next(new_weight);
+                events.push_back({arc, old_weight, new_weight});
+            }
+            delta_ends.push_back(events.size());
+        }
+        if (truncated || pos != end || delta_ends.size() != header.num_deltas
+                || events.size() != header.num_events) {
+            std::cerr << filename << " is truncated" << std::endl;
+            return false;
+        }
+        for (const auto &[tail, head] : arcs) {
+            if (tail >= num_vertices || head >= num_vertices) {
+                std::cerr << filename << " refers to unknown vertices" << std::endl;
+                return false;
+            }
+        }
+        for (const auto &event : events) {
+            if (event.arc >= arcs.size()) {
+                std::cerr << filename << " refers to unknown arcs" << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    std::uint64_t num_vertices = 0;
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> arcs;
+    std::vector<WeightEvent> events;
+    // End of the events of each delta
+    std::vector<std::size_t> delta_ends;
+};
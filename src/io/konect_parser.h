@@ -0,0 +1,52 @@
+/**
+ * Copyright (C) 2022-2023 : Kathrin Hanauer, Lara Ost
+ *
+ * This file is part of DyDJ Match.
+ *
+ * DyDJ Match is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DyDJ Match is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DyDJ Match.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact information:
+ *   https://github.com/DJ-Match/DyDJ-Match
+ */
+
+#pragma once
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "io/trace_update.h"
+
+// Read all updates from a Konect edge list with lines `<tail> <head> <weight> <timestamp>`.
+// Empty lines and comment lines (starting with '%') are skipped.
+// The updates are returned in file order, i.e., they are not necessarily sorted by timestamp.
+inline bool read_konect_updates(std::istream &input, std::vector<TraceUpdate> &updates) {
+    std::string line;
+    unsigned long long line_number = 0;
+    while (std::getline(input, line)) {
+        line_number++;
+        if (line.empty() || line.front() == '%') {
+            continue;
+        }
+        std::istringstream line_stream(line);
+        TraceUpdate update;
+        if (!(line_stream >> update.tail >> update.head >> update.weight >> update.timestamp)) {
+            std::cerr << "Malformed line " << line_number << ": '" << line << "'" << std::endl;
+            return false;
+        }
+        updates.push_back(update);
+    }
+    return true;
+}
@@ -0,0 +1,105 @@
+/**
+ * Copyright (C) 2022-2023 : Kathrin Hanauer, Lara Ost
+ *
+ * This file is part of DyDJ Match.
+ *
+ * DyDJ Match is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DyDJ Match is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DyDJ Match.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact information:
+ *   https://github.com/DJ-Match/DyDJ-Match
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Read-only memory mapping of a whole file.
+// Pages are shared via the page cache with every other process mapping the same file.
+class MappedFile {
+
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        close();
+    }
+
+    // Map `filename` into memory. Returns `false` if the file cannot be opened or mapped.
+    bool open(const std::string &filename) {
+        close();
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) != 0) {
+            ::close(fd);
+            return false;
+        }
+        file_size = static_cast<std::size_t>(file_stat.st_size);
+        if (file_size > 0) {
+            void *mapping = mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+            if (mapping == MAP_FAILED) {
+                ::close(fd);
+                file_size = 0;
+                return false;
+            }
+            file_data = static_cast<const unsigned char*>(mapping);
+        }
+        ::close(fd);
+        is_mapped = true;
+        return true;
+    }
+
+    void close() {
+        if (file_data != nullptr) {
+            munmap(const_cast<unsigned char*>(file_data), file_size);
+        }
+        file_data = nullptr;
+        file_size = 0;
+        is_mapped = false;
+    }
+
+    // Hint the kernel that the mapping is going to be read front to back.
+    void advise_sequential() const {
+        if (file_data != nullptr) {
+            madvise(const_cast<unsigned char*>(file_data), file_size, MADV_SEQUENTIAL);
+        }
+    }
+
+    bool is_open() const {
+        return is_mapped;
+    }
+
+    const unsigned char* data() const {
+        return file_data;
+    }
+
+    std::size_t size() const {
+        return file_size;
+    }
+
+private:
+    const unsigned char *file_data = nullptr;
+    std::size_t file_size = 0;
+    bool is_mapped = false;
+};
@@ -0,0 +1,224 @@
+/**
+ * Copyright (C) 2022-2023 : Kathrin Hanauer, Lara Ost
+ *
+ * This file is part of DyDJ Match.
+ *
+ * DyDJ Match is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DyDJ Match is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DyDJ Match.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact information:
+ *   https://github.com/DJ-Match/DyDJ-Match
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "io/trace_update.h"
+
+namespace konect_scan_detail {
+
+inline bool is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline void skip_blanks(const char *&pos, const char *end) {
+    while (pos != end && is_blank(*pos)) {
+        pos++;
+    }
+}
+
+inline void skip_line(const char *&pos, const char *end) {
+    while (pos != end && *pos != '\n') {
+        pos++;
+    }
+    if (pos != end) {
+        pos++;
+    }
+}
+
+// Scan an unsigned decimal integer starting at `pos`, skipping leading blanks.
+inline bool scan_unsigned(const char *&pos, const char *end, unsigned long long &value) {
+    skip_blanks(pos, end);
+    if (pos == end || *pos < '0' || *pos > '9') {
+        return false;
+    }
+    value = 0;
+    while (pos != end && *pos >= '0' && *pos <= '9') {
+        value = value * 10 + static_cast<unsigned long long>(*pos - '0');
+        pos++;
+    }
+    return true;
+}
+
+// Scan a signed decimal integer starting at `pos`, skipping leading blanks.
+inline bool scan_signed(const char *&pos, const char *end, long long &value) {
+    skip_blanks(pos, end);
+    bool negative = false;
+    if (pos != end && (*pos == '-' || *pos == '+')) {
+        negative = *pos == '-';
+        pos++;
+    }
+    unsigned long long magnitude;
+    if (!scan_unsigned(pos, end, magnitude)) {
+        return false;
+    }
+    value = negative ? -static_cast<long long>(magnitude) : static_cast<long long>(magnitude);
+    return true;
+}
+
+// Parse all lines in `[begin, end)`, which must start at the beginning of a line.
+// Returns the offset of the first malformed line relative to `begin`, or `end - begin` on success.
+inline std::size_t parse_chunk(const char *begin, const char *end, std::vector<TraceUpdate> &updates) {
+    const char *pos = begin;
+    while (pos != end) {
+        const char *line_start = pos;
+        skip_blanks(pos, end);
+        if (pos == end) {
+            break;
+        }
+        if (*pos == '\n' || *pos == '%') {
+            skip_line(pos, end);
+            continue;
+        }
+        TraceUpdate update;
+        if (!scan_unsigned(pos, end, update.tail) || !scan_unsigned(pos, end, update.head)
+                || !scan_signed(pos, end, update.weight) || !scan_unsigned(pos, end, update.timestamp)) {
+            return static_cast<std::size_t>(line_start - begin);
+        }
+        updates.push_back(update);
+        skip_line(pos, end);
+    }
+    return static_cast<std::size_t>(end - begin);
+}
+
+inline bool by_timestamp(const TraceUpdate &lop, const TraceUpdate &rop) {
+    return lop.timestamp < rop.timestamp;
+}
+
+} // end namespace konect_scan_detail
+
+// Parse a Konect edge list held in memory using `num_threads` threads.
+// The input is split into chunks at newline boundaries, each chunk is parsed and stably sorted
+// by timestamp on its own thread, and the chunks are then merged pairwise in parallel.
+// The result equals a stable sort of all updates by timestamp, i.e., updates with equal
+// timestamps keep their order from the file. Previous contents of `updates` are discarded.
+inline bool read_konect_updates_parallel(const char *data, std::size_t size, unsigned num_threads,
+                                         std::vector<TraceUpdate> &updates) {
+    using namespace konect_scan_detail;
+
+    num_threads = std::max(1U, num_threads);
+    // Chunk boundaries, each one directly after a newline (or at the start/end of the input).
+    std::vector<const char*> bounds{data};
+    for (unsigned i = 1; i < num_threads; i++) {
+        const char *pos = std::max(bounds.back(), data + size / num_threads * i);
+        while (pos != data + size && pos != data && *(pos - 1) != '\n') {
+            pos++;
+        }
+        bounds.push_back(pos);
+    }
+    bounds.push_back(data + size);
+    const std::size_t num_chunks = bounds.size() - 1;
+
+    std::vector<std::vector<TraceUpdate>> chunks(num_chunks);
+    std::vector<std::size_t> parsed(num_chunks);
+    std::vector<std::thread> workers;
+    for (std::size_t i = 0; i < num_chunks; i++) {
+        workers.emplace_back([&, i]() {
+            chunks[i].reserve(static_cast<std::size_t>(bounds[i + 1] - bounds[i]) / 16);
+            parsed[i] = parse_chunk(bounds[i], bounds[i + 1], chunks[i]);
+            if (!std::is_sorted(chunks[i].begin(), chunks[i].end(), by_timestamp)) {
+                std::stable_sort(chunks[i].begin(), chunks[i].end(), by_timestamp);
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    for (std::size_t i = 0; i < num_chunks; i++) {
+        if (bounds[i] + parsed[i] != bounds[i + 1]) {
+            const char *line_start = bounds[i] + parsed[i];
+            const char *line_end = line_start;
+            skip_line(line_end, bounds[i + 1]);
+            std::size_t line_number = 1 + std::count(data, line_start, '\n');
+            std::cerr << "Malformed line " << line_number << ": '"
+                      << std::string(line_start, line_end - (line_end != line_start && *(line_end - 1) == '\n'))
+                      << "'" << std::endl;
+            return false;
+        }
+    }
+
+    // Time-ordered files yield chunks that only need to be concatenated.
+    bool chunks_in_order = true;
+    const TraceUpdate *last_update = nullptr;
+    for (const auto &chunk : chunks) {
+        if (chunk.empty()) {
+            continue;
+        }
+        if (last_update != nullptr && by_timestamp(chunk.front(), *last_update)) {
+            chunks_in_order = false;
+            break;
+        }
+        last_update = &chunk.back();
+    }
+    if (chunks_in_order && num_chunks > 1) {
+        std::vector<std::size_t> offsets{0};
+        for (const auto &chunk : chunks) {
+            offsets.push_back(offsets.back() + chunk.size());
+        }
+        updates.resize(offsets.back());
+        workers.clear();
+        for (std::size_t i = 0; i < num_chunks; i++) {
+            workers.emplace_back([&, i]() {
+                std::copy(chunks[i].begin(), chunks[i].end(), updates.begin() + offsets[i]);
+            });
+        }
+        for (auto &worker : workers) {
+            worker.join();
+        }
+        return true;
+    }
+
+    // Merge neighboring chunks pairwise; std::merge prefers the left range on ties,
+    // so updates with equal timestamps stay in file order.
+    while (chunks.size() > 1) {
+        std::vector<std::vector<TraceUpdate>> merged((chunks.size() + 1) / 2);
+        workers.clear();
+        for (std::size_t i = 0; i + 1 < chunks.size(); i += 2) {
+            workers.emplace_back([&, i]() {
+                auto &target = merged[i / 2];
+                target.resize(chunks[i].size() + chunks[i + 1].size());
+                std::merge(chunks[i].begin(), chunks[i].end(), chunks[i + 1].begin(), chunks[i + 1].end(),
+                           target.begin(), by_timestamp);
+                std::vector<TraceUpdate>().swap(chunks[i]);
+                std::vector<TraceUpdate>().swap(chunks[i + 1]);
+            });
+        }
+        if (chunks.size() % 2 == 1) {
+            merged.back().swap(chunks.back());
+        }
+        for (auto &worker : workers) {
+            worker.join();
+        }
+        chunks.swap(merged);
+    }
+
+    updates.swap(chunks.front());
+    return true;
+}
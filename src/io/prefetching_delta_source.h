@@ -0,0 +1,165 @@
+/**
+ * Copyright (C) 2022-2023 : Kathrin Hanauer, Lara Ost
+ *
+ * This file is part of DyDJ Match.
+ *
+ * DyDJ Match is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DyDJ Match is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DyDJ Match.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact information:
+ *   https://github.com/DJ-Match/DyDJ-Match
+ */
+
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "io/delta_source.h"
+#include "io/trace_update.h"
+
+// Reads the deltas of another source on a background thread.
+// While an algorithm processes the current delta, the following deltas are already read,
+// parsed and grouped, so that only the graph mutation remains on the main thread.
+// At most `max_queued_deltas` deltas are staged at a time.
+class PrefetchingDeltaSource : public DeltaSource {
+
+public:
+    static constexpr std::size_t max_queued_deltas = 4;
+
+    explicit PrefetchingDeltaSource(std::unique_ptr<DeltaSource> source) : source(std::move(source)) {}
+    PrefetchingDeltaSource(const PrefetchingDeltaSource&) = delete;
+    PrefetchingDeltaSource& operator=(const PrefetchingDeltaSource&) = delete;
+
+    ~PrefetchingDeltaSource() {
+        stop();
+    }
+
+    virtual bool rewind() override {
+        stop();
+        error = !source->rewind();
+        if (!error) {
+            start();
+        }
+        return !error;
+    }
+
+    virtual bool next_delta(std::vector<TraceUpdate> &delta) override {
+        std::unique_lock<std::mutex> lock(mutex);
+        not_empty.wait(lock, [this]() { return !deltas.empty() || finished; });
+        if (deltas.empty()) {
+            error = source_failed;
+            delta.clear();
+            return false;
+        }
+        delta.swap(deltas.front());
+        // hand the previous buffer back for reuse
+        if (spare.size() < max_queued_deltas) {
+            spare.push_back(std::move(deltas.front()));
+        }
+        deltas.pop_front();
+        lock.unlock();
+        not_full.notify_one();
+        return true;
+    }
+
+    virtual bool seek(std::size_t delta) override {
+        stop();
+        error = !source->seek(delta);
+        if (!error) {
+            start();
+        }
+        return !error;
+    }
+
+    virtual std::size_t find_delta(TraceUpdate::timestamp_type timestamp) override {
+        stop();
+        return source->find_delta(timestamp);
+    }
+
+    virtual double decompression_time() const override {
+        std::lock_guard<std::mutex> lock(mutex);
+        return source->decompression_time();
+    }
+
+private:
+    void start() {
+        finished = false;
+        stopped = false;
+        source_failed = false;
+        producer = std::thread(&PrefetchingDeltaSource::produce, this);
+    }
+
+    void stop() {
+        if (producer.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopped = true;
+            }
+            not_full.notify_all();
+            producer.join();
+        }
+        deltas.clear();
+    }
+
+    void produce() {
+        std::vector<TraceUpdate> delta;
+        while (true) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!spare.empty()) {
+                    delta.swap(spare.back());
+                    spare.pop_back();
+                }
+            }
+            if (!source->next_delta(delta)) {
+                break;
+            }
+            std::unique_lock<std::mutex> lock(mutex);
+            not_full.wait(lock, [this]() { return deltas.size() < max_queued_deltas || stopped; });
+            if (stopped) {
+                return;
+            }
+            deltas.push_back(std::move(delta));
+            delta = {};
+            lock.unlock();
+            not_empty.notify_one();
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finished = true;
+            source_failed = source->failed();
+        }
+        not_empty.notify_all();
+    }
+
+    std::unique_ptr<DeltaSource> source;
+    std::thread producer;
+
+    mutable std::mutex mutex;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+    std::deque<std::vector<TraceUpdate>> deltas;
+    // Buffers of consumed deltas, which are refilled by the producer
+    std::vector<std::vector<TraceUpdate>> spare;
+    bool finished = false;
+    bool stopped = false;
+    bool source_failed = false;
+};
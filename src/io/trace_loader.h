@@ -0,0 +1,96 @@
+/**
+ * Copyright (C) 2022-2023 : Kathrin Hanauer, Lara Ost
+ *
+ * This file is part of DyDJ Match.
+ *
+ * DyDJ Match is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DyDJ Match is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DyDJ Match.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact information:
+ *   https://github.com/DJ-Match/DyDJ-Match
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "io/binary_trace.h"
+#include "io/compressed_input.h"
+#include "io/konect_parser.h"
+#include "io/mapped_file.h"
+#include "io/parallel_konect_parser.h"
+#include "io/trace_update.h"
+
+// Load all updates of a trace into memory, sorted by timestamp (stably, i.e., the updates of
+// a delta keep their file order). `filename` may be a binary trace or a, possibly compressed,
+// Konect edge list; text is parsed by `parse_threads` threads, or by a single one if it is 0.
+// For binary traces, the vertex ids are dense and `original_ids` receives their original ids;
+// otherwise, it is cleared.
+inline bool load_trace(const std::string &filename, unsigned parse_threads, std::vector<TraceUpdate> &updates,
+                       std::vector<TraceUpdate::vertex_id> &original_ids, double &decompression_seconds) {
+    updates.clear();
+    original_ids.clear();
+    decompression_seconds = 0;
+
+    if (BinaryTraceReader::is_binary_trace(filename)) {
+        BinaryTraceReader reader;
+        if (!reader.open(filename)) {
+            return false;
+        }
+        updates.reserve(reader.num_updates());
+        if (!reader.map_deltas([](TraceUpdate::timestamp_type, std::uint64_t) {},
+                               [&updates](const TraceUpdate &update) { updates.push_back(update); })) {
+            std::cerr << filename << " contains a malformed delta" << std::endl;
+            return false;
+        }
+        original_ids = reader.vertex_table();
+        return true;
+    }
+
+    if (parse_threads > 0 && compression_of(filename) == Compression::NONE) {
+        MappedFile file;
+        if (!file.open(filename)) {
+            std::cerr << "Could not open file " << filename << std::endl;
+            return false;
+        }
+        file.advise_sequential();
+        return read_konect_updates_parallel(reinterpret_cast<const char*>(file.data()), file.size(),
+                                            parse_threads, updates);
+    }
+
+    auto file = open_input(filename);
+    if (!file) {
+        std::cerr << "Could not open file " << filename << std::endl;
+        return false;
+    }
+    bool parsed;
+    if (parse_threads > 0) {
+        std::string text;
+        read_all(*file, text);
+        parsed = read_konect_updates_parallel(text.data(), text.size(), parse_threads, updates);
+    } else {
+        parsed = read_konect_updates(*file, updates);
+        std::stable_sort(updates.begin(), updates.end(), [](const TraceUpdate &lop, const TraceUpdate &rop) {
+            return lop.timestamp < rop.timestamp;
+        });
+    }
+    decompression_seconds = decompression_time(file.get());
+    if (decompression_failed(file.get())) {
+        std::cerr << "Could not decompress " << filename << std::endl;
+        return false;
+    }
+    return parsed;
+}
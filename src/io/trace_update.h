@@ -0,0 +1,60 @@
+/**
+ * Copyright (C) 2022-2023 : Kathrin Hanauer, Lara Ost
+ *
+ * This file is part of DyDJ Match.
+ *
+ * DyDJ Match is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DyDJ Match is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DyDJ Match.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact information:
+ *   https://github.com/DJ-Match/DyDJ-Match
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+// A single update of a temporal edge stream, as given by one line
+// `<tail> <head> <weight> <timestamp>` of a Konect file.
+// Updates with non-positive weight remove the arc `(tail, head)`.
+struct TraceUpdate {
+    using vertex_id = unsigned long long;
+    using timestamp_type = unsigned long long;
+
+    vertex_id tail;
+    vertex_id head;
+    long long weight;
+    timestamp_type timestamp;
+};
+
+// Key identifying the arc `(tail, head)` of an update, e.g., in hash maps.
+using TraceArcKey = std::pair<TraceUpdate::vertex_id, TraceUpdate::vertex_id>;
+
+struct TraceArcKeyHash {
+    std::size_t operator()(const TraceArcKey &key) const {
+        return std::hash<TraceUpdate::vertex_id>()(key.first * 0x9e3779b97f4a7c15ULL ^ key.second);
+    }
+};
+
+// Apply `update` to a dynamic graph offering `addArc` and `removeArc`, such as
+// `Algora::DynamicWeightedDiGraph`.
+template<typename DynamicGraph>
+void apply_trace_update(DynamicGraph *dyGraph, const TraceUpdate &update) {
+    if (update.weight > 0) {
+        dyGraph->addArc(update.tail, update.head, update.weight, update.timestamp);
+    } else {
+        dyGraph->removeArc(update.tail, update.head, update.timestamp);
+    }
+}
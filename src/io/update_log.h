@@ -0,0 +1,89 @@
+/**
+ * Copyright (C) 2022-2023 : Kathrin Hanauer, Lara Ost
+ *
+ * This file is part of DyDJ Match.
+ *
+ * DyDJ Match is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DyDJ Match is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DyDJ Match.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact information:
+ *   https://github.com/DJ-Match/DyDJ-Match
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include "io/trace_update.h"
+
+// All updates of a trace held in memory, grouped into deltas of identical timestamp.
+// The log is immutable once constructed.
+class UpdateLog {
+
+public:
+    UpdateLog() : delta_offsets{0} {}
+
+    // Pre-condition: `updates` is sorted by timestamp.
+    explicit UpdateLog(std::vector<TraceUpdate> &&updates) : updates(std::move(updates)) {
+        assert(std::is_sorted(this->updates.begin(), this->updates.end(), [](const TraceUpdate &lop, const TraceUpdate &rop) {
+            return lop.timestamp < rop.timestamp;
+        }));
+        delta_offsets.push_back(0);
+        for (std::size_t i = 1; i < this->updates.size(); i++) {
+            if (this->updates[i].timestamp != this->updates[i - 1].timestamp) {
+                delta_offsets.push_back(i);
+            }
+        }
+        if (!this->updates.empty()) {
+            delta_offsets.push_back(this->updates.size());
+        }
+    }
+
+    std::size_t num_deltas() const {
+        return delta_offsets.size() - 1;
+    }
+
+    std::size_t num_updates() const {
+        return updates.size();
+    }
+
+    // Updates of delta `delta` are in `[delta_begin(delta), delta_end(delta))`.
+    const TraceUpdate* delta_begin(std::size_t delta) const {
+        return updates.data() + delta_offsets[delta];
+    }
+
+    const TraceUpdate* delta_end(std::size_t delta) const {
+        return updates.data() + delta_offsets[delta + 1];
+    }
+
+    // Number of the first delta with a timestamp of at least `timestamp`, or `num_deltas()` if there is none.
+    std::size_t find_delta(TraceUpdate::timestamp_type timestamp) const {
+        auto it = std::lower_bound(delta_offsets.begin(), delta_offsets.end() - 1, timestamp,
+                                   [this](std::size_t offset, TraceUpdate::timestamp_type value) {
+            return updates[offset].timestamp < value;
+        });
+        return it - delta_offsets.begin();
+    }
+
+    const std::vector<TraceUpdate>& all_updates() const {
+        return updates;
+    }
+
+private:
+    std::vector<TraceUpdate> updates;
+    // Index of the first update of each delta, plus the total number of updates.
+    std::vector<std::size_t> delta_offsets;
+};
@@ -0,0 +1,72 @@
+/**
+ * Copyright (C) 2022-2023 : Kathrin Hanauer, Lara Ost
+ *
+ * This file is part of DyDJ Match.
+ *
+ * DyDJ Match is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DyDJ Match is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DyDJ Match.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact information:
+ *   https://github.com/DJ-Match/DyDJ-Match
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// LEB128-style variable-length integers: 7 bits of payload per byte,
+// the high bit is set on every byte except the last one.
+
+inline void append_varint(std::vector<unsigned char> &buffer, std::uint64_t value) {
+    while (value >= 0x80) {
+        buffer.push_back(static_cast<unsigned char>(value | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back(static_cast<unsigned char>(value));
+}
+
+// Decode a varint starting at `pos` and advance `pos` past it.
+// The caller is responsible for ensuring that the encoded value is complete.
+inline std::uint64_t read_varint(const unsigned char *&pos) {
+    std::uint64_t value = *pos & 0x7f;
+    unsigned shift = 7;
+    while (*pos++ & 0x80) {
+        value |= static_cast<std::uint64_t>(*pos & 0x7f) << shift;
+        shift += 7;
+    }
+    return value;
+}
+
+// Decode a varint starting at `pos` into `value` and advance `pos` past it, without reading at or past `end`.
+// Returns `false` if the encoded value is incomplete or exceeds 64 bits.
+inline bool read_varint(const unsigned char *&pos, const unsigned char *end, std::uint64_t &value) {
+    value = 0;
+    for (unsigned shift = 0; pos < end && shift < 64; shift += 7) {
+        const unsigned char byte = *pos++;
+        value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Zigzag mapping for signed values, so that small magnitudes yield short varints.
+inline std::uint64_t zigzag_encode(std::int64_t value) {
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+inline std::int64_t zigzag_decode(std::uint64_t value) {
+    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
@@ -0,0 +1,190 @@
+/**
+ * Copyright (C) 2022-2023 : Kathrin Hanauer, Lara Ost
+ *
+ * This file is part of DyDJ Match.
+ *
+ * DyDJ Match is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DyDJ Match is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DyDJ Match.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact information:
+ *   https://github.com/DJ-Match/DyDJ-Match
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "algorithm/matching_defs.h"
+#include "io/trace_update.h"
+
+namespace vertex_ordering_detail {
+
+// Undirected simple graph of all vertex pairs that ever share an arc, in CSR form.
+struct UnionGraph {
+    std::vector<std::uint64_t> offsets;
+    std::vector<std::uint64_t> neighbors;
+
+    std::uint64_t degree(std::uint64_t v) const {
+        return offsets[v + 1] - offsets[v];
+    }
+};
+
+inline UnionGraph build_union_graph(const std::vector<TraceUpdate> &updates, std::uint64_t num_vertices) {
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> edges;
+    edges.reserve(2 * updates.size());
+    for (const auto &update : updates) {
+        if (update.tail != update.head) {
+            edges.emplace_back(update.tail, update.head);
+            edges.emplace_back(update.head, update.tail);
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    UnionGraph graph;
+    graph.offsets.assign(num_vertices + 1, 0);
+    graph.neighbors.reserve(edges.size());
+    for (const auto &[u, v] : edges) {
+        graph.offsets[u + 1]++;
+        graph.neighbors.push_back(v);
+    }
+    std::partial_sum(graph.offsets.begin(), graph.offsets.end(), graph.offsets.begin());
+    return graph;
+}
+
+// Reverse Cuthill-McKee: breadth-first search from a vertex of minimum degree in each component,
+// visiting neighbors by increasing degree, and reversing the resulting order.
+inline std::vector<std::uint64_t> rcm_order(const UnionGraph &graph, std::uint64_t num_vertices) {
+    std::vector<std::uint64_t> by_degree(num_vertices);
+    std::iota(by_degree.begin(), by_degree.end(), 0);
+    std::stable_sort(by_degree.begin(), by_degree.end(), [&graph](std::uint64_t lop, std::uint64_t rop) {
+        return graph.degree(lop) < graph.degree(rop);
+    });
+
+    std::vector<bool> visited(num_vertices, false);
+    std::vector<std::uint64_t> order;
+    order.reserve(num_vertices);
+    std::vector<std::uint64_t> candidates;
+    for (auto start : by_degree) {
+        if (visited[start]) {
+            continue;
+        }
+        visited[start] = true;
+        // `order` doubles as the BFS queue
+        order.push_back(start);
+        for (auto next = order.size() - 1; next < order.size(); next++) {
+            const auto v = order[next];
+            candidates.clear();
+            for (auto i = graph.offsets[v]; i < graph.offsets[v + 1]; i++) {
+                if (!visited[graph.neighbors[i]]) {
+                    visited[graph.neighbors[i]] = true;
+                    candidates.push_back(graph.neighbors[i]);
+                }
+            }
+            std::stable_sort(candidates.begin(), candidates.end(), [&graph](std::uint64_t lop, std::uint64_t rop) {
+                return graph.degree(lop) < graph.degree(rop);
+            });
+            order.insert(order.end(), candidates.begin(), candidates.end());
+        }
+    }
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+} // end namespace vertex_ordering_detail
+
+// Renumber the vertices of `updates` densely, i.e., to `[0, n)`, in the given order:
+// - `FIRST_APPEARANCE`: in the order in which vertices first appear in `updates`;
+// - `DEGREE`: by decreasing number of distinct neighbors over the whole trace;
+// - `RCM`: in reverse Cuthill-McKee order of the graph of all arcs of the trace,
+//   so that neighboring vertices receive nearby ids.
+// `original_ids` maps the ids used in `updates` to original ids, or is empty if they are original.
+// It is replaced by the mapping of the new ids to the original ids.
+inline void compact_vertex_ids(std::vector<TraceUpdate> &updates, VertexOrder order,
+                               std::vector<TraceUpdate::vertex_id> &original_ids) {
+    using namespace vertex_ordering_detail;
+
+    if (order == VertexOrder::NONE) {
+        return;
+    }
+
+    // Dense ids by first appearance
+    std::unordered_map<TraceUpdate::vertex_id, std::uint64_t> dense_ids;
+    std::vector<TraceUpdate::vertex_id> first_ids;
+    auto dense_id = [&dense_ids, &first_ids](TraceUpdate::vertex_id id) {
+        auto [it, inserted] = dense_ids.try_emplace(id, first_ids.size());
+        if (inserted) {
+            first_ids.push_back(id);
+        }
+        return it->second;
+    };
+    for (auto &update : updates) {
+        update.tail = dense_id(update.tail);
+        update.head = dense_id(update.head);
+    }
+    const std::uint64_t num_vertices = first_ids.size();
+
+    // new_ids[v] is the new id of the vertex with dense id v
+    std::vector<std::uint64_t> new_ids(num_vertices);
+    if (order == VertexOrder::FIRST_APPEARANCE) {
+        std::iota(new_ids.begin(), new_ids.end(), 0);
+    } else {
+        const auto graph = build_union_graph(updates, num_vertices);
+        std::vector<std::uint64_t> ordered;
+        if (order == VertexOrder::DEGREE) {
+            ordered.resize(num_vertices);
+            std::iota(ordered.begin(), ordered.end(), 0);
+            std::stable_sort(ordered.begin(), ordered.end(), [&graph](std::uint64_t lop, std::uint64_t rop) {
+                return graph.degree(lop) > graph.degree(rop);
+            });
+        } else {
+            ordered = rcm_order(graph, num_vertices);
+        }
+        for (std::uint64_t i = 0; i < num_vertices; i++) {
+            new_ids[ordered[i]] = i;
+        }
+        for (auto &update : updates) {
+            update.tail = new_ids[update.tail];
+            update.head = new_ids[update.head];
+        }
+    }
+
+    std::vector<TraceUpdate::vertex_id> new_original_ids(num_vertices);
+    for (std::uint64_t v = 0; v < num_vertices; v++) {
+        new_original_ids[new_ids[v]] = original_ids.empty() ? first_ids[v] : original_ids[first_ids[v]];
+    }
+    original_ids.swap(new_original_ids);
+}
+
+// Number of distinct vertices and arcs `(tail, head)` occurring in `updates`.
+inline void count_vertices_and_arcs(const std::vector<TraceUpdate> &updates,
+                                    std::uint64_t &num_vertices, std::uint64_t &num_arcs) {
+    std::vector<std::pair<TraceUpdate::vertex_id, TraceUpdate::vertex_id>> arcs;
+    std::vector<TraceUpdate::vertex_id> vertices;
+    arcs.reserve(updates.size());
+    vertices.reserve(2 * updates.size());
+    for (const auto &update : updates) {
+        arcs.emplace_back(update.tail, update.head);
+        vertices.push_back(update.tail);
+        vertices.push_back(update.head);
+    }
+    std::sort(arcs.begin(), arcs.end());
+    num_arcs = std::unique(arcs.begin(), arcs.end()) - arcs.begin();
+    std::sort(vertices.begin(), vertices.end());
+    num_vertices = std::unique(vertices.begin(), vertices.end()) - vertices.begin();
+}
@@ -0,0 +1,130 @@
+/**
+ * Copyright (C) 2022-2023 : Kathrin Hanauer, Lara Ost
+ *
+ * This file is part of DyDJ Match.
+ *
+ * DyDJ Match is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DyDJ Match is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DyDJ Match.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact information:
+ *   https://github.com/DJ-Match/DyDJ-Match
+ */
+
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "io/delta_source.h"
+#include "io/trace_update.h"
+
+enum class WindowType {
+    // Updates whose timestamps fall into the same span of fixed length form a delta
+    TIME,
+    // Every fixed number of consecutive updates form a delta
+    UPDATES
+};
+
+// Regroups the deltas of another source into windows.
+// Fine-grained traces consist of many tiny deltas, each of which causes a run of every algorithm.
+// Time windows start at the first timestamp of the trace and contain at least one update;
+// update windows may split the updates of a timestamp.
+class WindowedDeltaSource : public DeltaSource {
+
+public:
+    WindowedDeltaSource(std::unique_ptr<DeltaSource> source, WindowType type, unsigned long long size)
+        : source(std::move(source)), type(type), size(std::max<unsigned long long>(size, 1)) {}
+
+    virtual bool rewind() override {
+        pending.clear();
+        pending_position = 0;
+        first_timestamp.reset();
+        source_deltas = 0;
+        error = !source->rewind();
+        return !error;
+    }
+
+    virtual bool next_delta(std::vector<TraceUpdate> &delta) override {
+        delta.clear();
+        if (error || (pending_position == pending.size() && !fetch())) {
+            return false;
+        }
+        if (type == WindowType::UPDATES) {
+            do {
+                auto take = std::min<std::size_t>(size - delta.size(), pending.size() - pending_position);
+                delta.insert(delta.end(), pending.begin() + pending_position, pending.begin() + pending_position + take);
+                pending_position += take;
+            } while (delta.size() < size && (pending_position < pending.size() || fetch()));
+        } else {
+            if (!first_timestamp) {
+                first_timestamp = pending.front().timestamp;
+            }
+            const auto window = window_of(pending.front().timestamp);
+            do {
+                delta.insert(delta.end(), pending.begin() + pending_position, pending.end());
+                pending_position = pending.size();
+            } while (fetch() && window_of(pending.front().timestamp) == window);
+        }
+        error = source->failed();
+        return !error;
+    }
+
+    // Number of the first window containing a timestamp of at least `timestamp`.
+    virtual std::size_t find_delta(TraceUpdate::timestamp_type timestamp) override {
+        std::size_t count = 0;
+        std::vector<TraceUpdate> delta;
+        if (rewind()) {
+            while (next_delta(delta) && delta.back().timestamp < timestamp) {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    virtual double decompression_time() const override {
+        return source->decompression_time();
+    }
+
+    // Number of deltas of the underlying source read since the last rewind.
+    std::size_t deltas_read() const {
+        return source_deltas;
+    }
+
+private:
+    bool fetch() {
+        pending_position = 0;
+        if (!source->next_delta(pending)) {
+            return false;
+        }
+        source_deltas++;
+        return true;
+    }
+
+    unsigned long long window_of(TraceUpdate::timestamp_type timestamp) const {
+        return (timestamp - *first_timestamp) / size;
+    }
+
+    std::unique_ptr<DeltaSource> source;
+    const WindowType type;
+    const unsigned long long size;
+    // Delta of the underlying source that is currently being distributed into windows
+    std::vector<TraceUpdate> pending;
+    std::size_t pending_position = 0;
+    std::optional<TraceUpdate::timestamp_type> first_timestamp;
+    std::size_t source_deltas = 0;
+};
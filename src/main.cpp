@@ -20,6 +20,7 @@
  *   https://github.com/DJ-Match/DyDJ-Match
  */
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <ostream>
@@ -30,20 +31,226 @@
 #include <ratio>
 #include <iomanip>
 #include <random>
+#include <optional>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <iterator>
+#include <mutex>
+#include <numeric>
+#include <sstream>
+#include <thread>
 
 #include "graph.dyn/dynamicweighteddigraph.h"
 #include "io/konectnetworkreader.h"
 
 #include "algoraapp_info.h"
+#include "datastructure/streaming_digraph.h"
+#include "io/binary_trace.h"
+#include "io/coloring_diff.h"
+#include "io/compressed_input.h"
+#include "io/delta_coalescing.h"
+#include "io/delta_source.h"
+#include "io/demand_decay.h"
+#include "io/prefetching_delta_source.h"
+#include "io/trace_loader.h"
+#include "io/vertex_ordering.h"
+#include "io/windowed_delta_source.h"
 #include "parse_configuration.h"
 #include "parse_parameters.h"
+#include "tools/callback_timer.h"
 #include "tools/chronotimer.h"
 #include "tools/datatable.h"
+#include "tools/event_recorder.h"
+#include "tools/isolated_run.h"
+#include "tools/repeated_runs.h"
+#include "tools/result_table.h"
 
-// Format specification for doubles
-template<>
-void format<double>(std::ostream &stream) {
-    stream << std::fixed << std::setprecision(6);
+// Statistics of replaying the trace, accumulated over all runs using the same delta source
+struct ReplayStats {
+    DeltaCoalescer coalescer;
+    double io_time = 0;
+    int windows = 0;
+    // Time spent applying deltas outside the observers of the algorithms, when several algorithms share a replay
+    double shared_delta_time = 0;
+};
+
+// Results of a run in a child process, besides its rows
+struct IsolatedRunReport {
+    bool success;
+    bool consistent;
+    double io_time;
+    int windows;
+    std::size_t grouped_timestamps;
+    std::uint64_t total_updates;
+    std::uint64_t remaining_updates;
+    double shared_delta_time;
+    double decompression_time;
+};
+
+// Replay the trace from `source` on a new graph and run each of `algos[i]` with `bs[i]` matchings after each delta.
+// If `first_delta > 0`, the graph is bulk-loaded from `start_state`, the state after the deltas before it.
+// With `bulk_init`, it is built before the algorithms observe it, and each of them takes it over at once.
+// Several algorithms observe the same graph, so each delta is applied only once; their delta times then
+// cover only the time spent in their own observers, and the remaining time is added to `stats`.
+// They also share the order of the arcs by weight, which is computed by the first algorithm that needs it.
+// If `events` is given, the weight changes of each delta are recorded in it.
+// If `repetitions` is given, the results are recorded there instead of writing them to `table`.
+// If `diffs` is given, the coloring changes of each delta are written to it (only in the first of repeated replays).
+bool replay_trace(const std::vector<AlgorithmBase*> &algos, const std::vector<int> &bs, const MatchingConfig &config,
+                  DeltaSource &source, std::size_t first_delta, const std::vector<TraceUpdate> &start_state,
+                  ResultTable &table, ReplayStats &stats, EventLog *events = nullptr,
+                  RepeatedRuns *repetitions = nullptr, ColoringDiffWriter *diffs = nullptr) {
+    StreamingWeightedDiGraph<EdgeWeight> streamingGraph;
+    // Create renumbered vertices up front, so that their ids follow the chosen order
+    streamingGraph.reserveVertices(config.original_vertex_ids.size());
+    if (!(first_delta > 0 ? source.seek(first_delta) : source.rewind())) {
+        return false;
+    }
+    std::optional<DemandDecay> decay;
+    if (config.decay_half_life > 0) {
+        decay.emplace(config.decay_half_life);
+    }
+    std::optional<EventRecorder<EdgeWeight>> recorder;
+    if (events) {
+        recorder.emplace(streamingGraph.getArcWeights(), *events);
+    }
+    // Build the graph as of `first_delta` without notifying the algorithms of each of its arcs
+    const bool bulk_init = config.bulk_init && first_delta > 0;
+    ChronoTimer deltaTimer;
+    double buildTime = 0;
+    if (bulk_init) {
+        streamingGraph.applyDelta(start_state);
+        buildTime = deltaTimer.elapsed<>();
+    }
+    std::optional<SortedArcs> sortedArcs;
+    std::optional<CallbackTimer<EdgeWeight>> callbackTimer;
+    if (algos.size() > 1) {
+        sortedArcs.emplace(streamingGraph.getDiGraph(), streamingGraph.getArcWeights());
+        callbackTimer.emplace(streamingGraph.getDiGraph(), streamingGraph.getArcWeights(), algos.size());
+    }
+    std::vector<double> initTimes(algos.size(), 0);
+    for (std::size_t i = 0; i < algos.size(); i++) {
+        if (callbackTimer) {
+            callbackTimer->add_marker(i);
+        }
+        algos[i]->setGraph(streamingGraph.getDiGraph());
+        algos[i]->setWeights(streamingGraph.getArcWeights());
+        algos[i]->set_num_matchings(bs[i]);
+        algos[i]->set_sorted_arcs(sortedArcs ? &*sortedArcs : nullptr);
+        algos[i]->set_trace_vertex_ids(&streamingGraph.getTraceIds());
+        if (bulk_init) {
+            deltaTimer.restart();
+            algos[i]->bulk_init();
+            initTimes[i] = deltaTimer.elapsed<>();
+        } else {
+            algos[i]->init();
+        }
+    }
+    if (callbackTimer) {
+        callbackTimer->add_marker(algos.size());
+    }
+    // Run all algorithms on the delta just applied, which took `deltaTime` overall.
+    // If the algorithms share the graph, `algoDeltaTimes` may give the time each of them spent on the delta.
+    auto run_algorithms = [&](int delta_counter, double deltaTime, unsigned long delta_size,
+                              const std::vector<double> *algoDeltaTimes = nullptr) {
+        if (events) {
+            events->end_delta();
+        }
+        double callbackTime = 0;
+        for (std::size_t i = 0; i < algos.size(); i++) {
+            double algoDeltaTime = deltaTime;
+            if (callbackTimer) {
+                algoDeltaTime = algoDeltaTimes ? (*algoDeltaTimes)[i] : callbackTimer->take(i);
+                callbackTime += algoDeltaTime;
+            }
+            run_delta(algos[i], bs[i], delta_counter, algoDeltaTime, streamingGraph.getDiGraph(), delta_size,
+                      decay ? &*decay : nullptr, table, repetitions);
+            if (diffs && (!repetitions || repetitions->keeps_rows())) {
+                for (auto b: algos[i]->get_nested_bs()) {
+                    diffs->add_delta(*algos[i], b, delta_counter, b);
+                }
+                if (algos[i]->get_nested_bs().empty()) {
+                    diffs->add_delta(*algos[i], bs[i], delta_counter);
+                }
+            }
+        }
+        if (callbackTimer) {
+            stats.shared_delta_time += deltaTime - callbackTime;
+        }
+    };
+    int delta_counter = first_delta;
+    if (bulk_init) {
+        // The delta time of each algorithm covers taking over the graph
+        run_algorithms(delta_counter, buildTime + std::accumulate(initTimes.begin(), initTimes.end(), 0.0),
+                       start_state.size(), &initTimes);
+    } else if (first_delta > 0) {
+        // Bulk-load the graph as of the last skipped delta
+        deltaTimer.restart();
+        streamingGraph.applyDelta(start_state);
+        run_algorithms(delta_counter, deltaTimer.elapsed<>(), start_state.size());
+    }
+    std::vector<TraceUpdate> delta;
+    deltaTimer.restart();
+    while (source.next_delta(delta)) {
+        delta_counter++;
+        stats.io_time += deltaTimer.elapsed<>();
+        deltaTimer.restart();
+        if (decay) {
+            decay->apply(delta);
+        }
+        if (config.coalesce_updates) {
+            stats.coalescer.coalesce(delta, [&streamingGraph](const TraceArcKey &key) {
+                return static_cast<long long>(streamingGraph.getWeight(key));
+            });
+        }
+        streamingGraph.applyDelta(delta);
+        // Measure time of transforming and applying the delta
+        run_algorithms(delta_counter, deltaTimer.elapsed<>(), delta.size());
+        deltaTimer.restart();
+    }
+    stats.windows = delta_counter;
+    for (auto *algo : algos) {
+        algo->unsetGraph();
+        algo->unsetWeights();
+        algo->set_sorted_arcs(nullptr);
+        algo->set_trace_vertex_ids(nullptr);
+    }
+    return !source.failed();
+}
+
+// Replay the trace for `algos` and `bs` as configured by `repeat` and `warmup`, see `replay_trace`.
+// With repetitions, the times of each delta are summarized over the measured replays, and
+// `consistent` is cleared if the replays computed different solutions.
+// Only the first replay contributes to `stats`.
+bool replay_repeated(const std::vector<AlgorithmBase*> &algos, const std::vector<int> &bs, const MatchingConfig &config,
+                     DeltaSource &source, std::size_t first_delta, const std::vector<TraceUpdate> &start_state,
+                     ResultTable &table, ReplayStats &stats, bool &consistent, ColoringDiffWriter *diffs = nullptr) {
+    if (config.repeat == 1 && config.warmup == 0) {
+        return replay_trace(algos, bs, config, source, first_delta, start_state, table, stats, nullptr, nullptr, diffs);
+    }
+    // With a time budget, the solutions depend on when the deadlines expire
+    RepeatedRuns repetitions(config.warmup, config.repeat, config.delta_time_budget <= 0);
+    ReplayStats repeated_stats;
+    while (repetitions.next_replay()) {
+        if (!replay_trace(algos, bs, config, source, first_delta, start_state, table,
+                          repetitions.keeps_rows() ? stats : repeated_stats, nullptr, &repetitions, diffs)) {
+            return false;
+        }
+    }
+    if (!write_repeated_runs(repetitions, table)) {
+        consistent = false;
+    }
+    return true;
+}
+
+// Instantiate the algorithms of the configuration `config_text` once more, without repeating its output.
+// Errors in the configuration are still reported.
+bool read_algorithms(const std::string &config_text, MatchingConfig config,
+                     std::vector<std::unique_ptr<AlgorithmBase>> &algos) {
+    std::istringstream input(config_text);
+    std::ostream quiet(nullptr);
+    return ConfigReader(config, input, algos, quiet).readConfig();
 }
 
 int main(int argc, char **argv) {
@@ -60,8 +267,16 @@ int main(int argc, char **argv) {
     }
 
     // Read the configuration from standard input
+    // Parallel runs and runs sharing the replay between all b need an instance of each algorithm per b,
+    // so the configuration is kept.
     std::vector<std::unique_ptr<AlgorithmBase>> algos;
-    if (!ConfigReader(*config, std::cin, algos).readConfig()) {
+    std::string config_text;
+    const bool instance_per_b = config->threads > 1 || config->shared_b;
+    if (instance_per_b) {
+        config_text.assign(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+    }
+    std::istringstream config_input(config_text);
+    if (!ConfigReader(*config, instance_per_b ? config_input : std::cin, algos).readConfig()) {
         std::cerr << "Error reading configuration from stdin" << std::endl;
         return 1;
     }
@@ -74,7 +289,8 @@ int main(int argc, char **argv) {
     std::streambuf *buffer;
     std::ofstream output_file_stream;
     if (config->writeOutputfile) {
-        output_file_stream.open(config->outputFile);
+        output_file_stream.open(config->outputFile, config->binary_results ? std::ios::out | std::ios::binary
+                                                                           : std::ios::out);
         if (!output_file_stream.is_open()) {
             std::cerr << "Failed to open output file " << config->outputFile << std::endl;
             return 1;
@@ -90,27 +306,113 @@ int main(int argc, char **argv) {
               << "GIT_REVISION: " << Algora::AlgoraAppInfo::GIT_REVISION << "\n"
               << "GIT_TIMESTAMP: " << Algora::AlgoraAppInfo::GIT_TIMESTAMP << "\n";
 
-    // Prepare the graph file
-    std::ifstream graph_file;
-    graph_file.open(graph_filename);
-
-    if (!graph_file.is_open()) {
+    // In streaming mode, the trace is read one delta at a time while running each algorithm
+    if (config->stream_input && !make_delta_source(graph_filename)->rewind()) {
         std::cout << "Error! Could not open file " << graph_filename << "\n";
         return 1;
     }
 
+    // Prepare the graph file
+    // Binary traces (see `DyDjConvertTrace`) are memory-mapped instead of parsed.
+    // Compressed text files are decompressed on a separate thread while being read.
+    const bool binary_trace = BinaryTraceReader::is_binary_trace(graph_filename);
+    const bool compressed = compression_of(graph_filename) != Compression::NONE;
+    std::unique_ptr<std::istream> graph_file;
+    BinaryTraceReader binary_reader;
+    const bool windowed = config->window_span > 0 || config->window_updates > 0;
+    // Unless streamed, traces replayed through a delta source are kept in memory
+    const bool in_memory_log = !config->stream_input && needs_own_delta_handling(*config);
+    if (needs_own_delta_handling(*config)) {
+        // nothing to prepare
+    } else if (binary_trace) {
+        if (!binary_reader.open(graph_filename)) {
+            std::cout << "Error! Could not open binary trace " << graph_filename << "\n";
+            return 1;
+        }
+    } else if (config->parse_threads > 0) {
+        // the file is mapped or decompressed by `load_trace`
+    } else {
+        graph_file = open_input(graph_filename);
+
+        if (!graph_file) {
+            std::cout << "Error! Could not open file " << graph_filename << "\n";
+            return 1;
+        }
+    }
+
     // Start a timer, this is reused later
     ChronoTimer timer;
 
     // Graph IO
     Algora::DynamicWeightedDiGraph<EdgeWeight> G(0);
-    Algora::KonectNetworkReader reader;
-    reader.setInputStream(&graph_file);
-    reader.removeNonPositiveWeightedArcs(true);
-    reader.provideDynamicWeightedDiGraph(&G);
-    graph_file.close();
-    std::cout << "Input I/O took " << timer.elapsed() << "s\n";
-    std::cout << "%n,m " << G.getConstructedGraphSize() << "," << G.getConstructedArcSize() << "\n";
+    double decompressionTime = 0;
+    std::uint64_t loadedVertices = 0;
+    std::uint64_t loadedArcs = 0;
+    // Immutable in-memory trace, shared by all replay cursors
+    std::shared_ptr<const UpdateLog> update_log;
+    if (config->stream_input) {
+        // Deltas are read on demand, only the ids of the input are needed up front
+        if (binary_trace) {
+            if (!binary_reader.open(graph_filename)) {
+                std::cout << "Error! Could not open binary trace " << graph_filename << "\n";
+                return 1;
+            }
+            config->original_vertex_ids = binary_reader.vertex_table();
+        }
+    } else if (in_memory_log) {
+        // Keep the (renumbered) trace in memory and replay it like a stream
+        std::vector<TraceUpdate> updates;
+        std::vector<TraceUpdate::vertex_id> original_ids;
+        if (!load_trace(graph_filename, config->parse_threads, updates, original_ids, decompressionTime)) {
+            std::cout << "Error! Could not read file " << graph_filename << "\n";
+            return 1;
+        }
+        // Binary traces come with dense ids, which are mapped to the input ids like renumbered ones
+        compact_vertex_ids(updates, config->vertex_order, original_ids);
+        config->original_vertex_ids = std::move(original_ids);
+        count_vertices_and_arcs(updates, loadedVertices, loadedArcs);
+        update_log = std::make_shared<UpdateLog>(std::move(updates));
+    } else if (binary_trace) {
+        if (!binary_reader.provideDynamicWeightedDiGraph(&G)) {
+            std::cout << "Error! Could not read binary trace " << graph_filename << "\n";
+            return 1;
+        }
+        config->original_vertex_ids = binary_reader.vertex_table();
+    } else if (config->parse_threads > 0) {
+        std::vector<TraceUpdate> updates;
+        std::vector<TraceUpdate::vertex_id> original_ids;
+        if (!load_trace(graph_filename, config->parse_threads, updates, original_ids, decompressionTime)) {
+            std::cout << "Error! Could not parse file " << graph_filename << "\n";
+            return 1;
+        }
+        for (const auto &update : updates) {
+            apply_trace_update(&G, update);
+        }
+    } else {
+        Algora::KonectNetworkReader reader;
+        reader.setInputStream(graph_file.get());
+        reader.removeNonPositiveWeightedArcs(true);
+        reader.provideDynamicWeightedDiGraph(&G);
+        if (decompression_failed(graph_file.get())) {
+            std::cout << "Error! Could not decompress file " << graph_filename << "\n";
+            return 1;
+        }
+    }
+    if (graph_file) {
+        decompressionTime = decompression_time(graph_file.get());
+        graph_file.reset();
+    }
+    if (!config->stream_input) {
+        std::cout << "Input I/O took " << timer.elapsed() << "s\n";
+        if (compressed) {
+            std::cout << "Decompression took " << decompressionTime << "s\n";
+        }
+        if (update_log) {
+            std::cout << "%n,m " << loadedVertices << "," << loadedArcs << "\n";
+        } else {
+            std::cout << "%n,m " << G.getConstructedGraphSize() << "," << G.getConstructedArcSize() << "\n";
+        }
+    }
 
     // Print command line arguments
     std::cout << "called with params: \n";
@@ -122,97 +424,360 @@ int main(int argc, char **argv) {
     if (config->all_bs.empty()) {
         config->all_bs.push_back(1);
     }
-    if (config->algorithm_order_seed != 0) {
-        std::mt19937 rng;
-        rng.seed(config->algorithm_order_seed);
-        std::shuffle(algos.begin(), algos.end(), rng);
-    }
+    auto order_algorithms = [&config](std::vector<std::unique_ptr<AlgorithmBase>> &instances) {
+        if (config->algorithm_order_seed != 0) {
+            std::mt19937 rng;
+            rng.seed(config->algorithm_order_seed);
+            std::shuffle(instances.begin(), instances.end(), rng);
+        }
+    };
+    order_algorithms(algos);
 
     auto *diGraph = G.getDiGraph();
     auto *weights = G.getArcWeights();
 
     // Set up the table for managing/printing the results
-    DataTable<false,
-              TableEntry<3, int>,
-              TableEntry<7, int>,
-              TableEntry<25, std::string>,
-              TableEntry<20, unsigned long>,
-              TableEntry<12, double>,
-              TableEntry<15, double>,
-              TableEntry<15, double>,
-              TableEntry<12, long>,
-              TableEntry<14, long>,
-              TableEntry<14, long>,
-              TableEntry<12, long>,
-              TableEntry<14, long>,
-              TableEntry<14, long>,
-              TableEntry<14, long>,
-              TableEntry<14, long>> table({"b",
-                                           "Delta",
-                                           "Algorithm",
-                                           "Weight",
-                                           "Time (s)",
-                                           "Delta-Time (s)",
-                                           "Total Time (s)",
-                                           "# color/up.",
-                                           "# uncolor/up.",
-                                           "# recolor/up.",
-                                           "# color/D",
-                                           "# uncolor/D",
-                                           "# recolor/D",
-                                           "# edges",
-                                           "size of delta"},
-                                          output_stream);
+    const auto results_format = config->binary_results ? TableFormat::BINARY : TableFormat::CSV;
+    ResultTable table(result_columns, output_stream, results_format);
 
     table.printHeader();
-    ChronoTimer deltaTimer;
-    for (auto b: config->all_bs) {
-        config->b = b;
-        for (auto &algo: algos) {
-            G.resetToBigBang();
-            weights->resetAll();
-            algo->setGraph(diGraph);
-            algo->setWeights(weights);
-            algo->set_num_matchings(b);
-            algo->init();
-            int delta_counter = 0;
-            deltaTimer.restart();
-            while(G.applyNextDelta()) {
-                delta_counter++;
-                auto deltaTime = deltaTimer.elapsed<>(); // Measure time of 'applyNextDelta()'
-                timer.restart();
-                algo->run();
-                auto time = timer.elapsed<>();
-                algo->post_run();
-
-                table.addRow(b,
-                            delta_counter,
-                            algo->getName(),
-                            algo->deliver(),
-                            time,
-                            deltaTime,
-                            deltaTime + time,
-                            algo->get_fine_counts().color_count,
-                            algo->get_fine_counts().uncolor_count,
-                            algo->get_fine_counts().recolor_count,
-                            algo->get_coarse_counts().color_count,
-                            algo->get_coarse_counts().uncolor_count,
-                            algo->get_coarse_counts().recolor_count,
-                            diGraph->getNumArcs(false),
-                            G.getSizeOfLastDelta());
-                table.flush();
-
-                algo->custom_output(output_stream);
-
-                deltaTimer.restart();
+
+    // Replays starting after the first delta skip the earlier ones of an uncompressed text trace via its index,
+    // which is loaded or built only once for all sources
+    std::shared_ptr<const DeltaIndex> delta_index;
+    if (config->stream_input && (config->start_delta > 0 || config->start_timestamp || config->bulk_init)) {
+        delta_index = load_delta_index(graph_filename);
+    }
+
+    // Every replay cursor over the trace reads from the input file or the shared in-memory log,
+    // possibly regrouped into windows and prefetched on a background thread
+    auto make_source = [&](WindowedDeltaSource **windows) -> std::unique_ptr<DeltaSource> {
+        std::unique_ptr<DeltaSource> source;
+        if (update_log) {
+            source = std::make_unique<LogDeltaSource>(update_log);
+        } else {
+            source = make_delta_source(graph_filename, delta_index);
+        }
+        if (windowed) {
+            auto type = config->window_span > 0 ? WindowType::TIME : WindowType::UPDATES;
+            auto size = config->window_span > 0 ? config->window_span : config->window_updates;
+            auto windowed_source = std::make_unique<WindowedDeltaSource>(std::move(source), type, size);
+            if (windows) {
+                *windows = windowed_source.get();
+            }
+            source = std::move(windowed_source);
+        }
+        // Stage the following deltas on a background thread, such that only applying them remains
+        if (config->prefetch_deltas) {
+            source = std::make_unique<PrefetchingDeltaSource>(std::move(source));
+        }
+        return source;
+    };
+    WindowedDeltaSource *windows = nullptr;
+    std::unique_ptr<DeltaSource> delta_source;
+    if (config->stream_input || update_log) {
+        delta_source = make_source(&windows);
+    }
+
+    // Deltas before the start delta are folded into a single bulk update, which is computed only once.
+    // With bulk initialization, this snapshot includes at least the first delta.
+    std::size_t firstDelta = 0;
+    std::vector<TraceUpdate> startState;
+    if (delta_source && (config->start_delta > 0 || config->start_timestamp || config->bulk_init)) {
+        timer.restart();
+        if (config->start_timestamp) {
+            firstDelta = delta_source->find_delta(*config->start_timestamp);
+        } else if (config->start_delta > 0) {
+            firstDelta = config->start_delta - 1;
+        }
+        if (config->bulk_init) {
+            firstDelta = std::max<std::size_t>(firstDelta, 1);
+        }
+        if (!aggregate_deltas(*delta_source, firstDelta, startState)) {
+            std::cerr << "Error reading " << graph_filename << std::endl;
+            return 1;
+        }
+        std::cout << "Aggregating " << firstDelta << " deltas took " << timer.elapsed() << "s\n";
+    }
+
+    // Record the weight changes seen by the algorithms, which `DyDjReplayEvents` replays without a dynamic graph
+    if (!config->capture_events_file.empty()) {
+        timer.restart();
+        EventLog events;
+        ReplayStats captureStats;
+        if (!replay_trace({}, {}, *config, *delta_source, firstDelta, startState, table, captureStats, &events)) {
+            std::cerr << "Error reading " << graph_filename << std::endl;
+            return 1;
+        }
+        std::ofstream events_file(config->capture_events_file, std::ios::binary | std::ios::trunc);
+        if (!events_file.is_open() || !events.write(events_file)) {
+            std::cout << "Error! Could not write file " << config->capture_events_file << "\n";
+            return 1;
+        }
+        std::cout << "Capturing " << events.num_events() << " events in " << events.num_deltas()
+                  << " deltas took " << timer.elapsed() << "s\n";
+    }
+
+    // Write the coloring changes of each delta, see `io/coloring_diff.h`
+    std::optional<ColoringDiffWriter> diffs;
+    if (!config->diff_output_file.empty()) {
+        std::vector<std::string> names;
+        for (const auto &algo: algos) {
+            names.push_back(algo->getName());
+        }
+        diffs.emplace();
+        if (!diffs->open(config->diff_output_file, names)) {
+            return 1;
+        }
+    }
+
+    ReplayStats stats;
+    double decompression_seconds = 0;
+    // Whether repeated runs computed the same solutions
+    bool consistent = true;
+    // Number of timestamps grouped into windows by the last isolated run
+    std::size_t isolated_timestamps = 0;
+    // Instances of the algorithms for each b, if needed
+    std::vector<std::vector<std::unique_ptr<AlgorithmBase>>> instances;
+    if (instance_per_b) {
+        instances.resize(config->all_bs.size());
+        instances[0] = std::move(algos);
+        for (std::size_t i = 1; i < instances.size(); i++) {
+            if (!read_algorithms(config_text, *config, instances[i])) {
+                return 1;
+            }
+            order_algorithms(instances[i]);
+            for (auto &algo: instances[i]) {
+                algo->configure(config);
             }
-            algo->unsetGraph();
-            algo->unsetWeights();
+        }
+    }
+    if (config->threads > 1) {
+        // Run each (b, algorithm) pair as a separate job on its own algorithm instance.
+        // The jobs are ordered like the sequential runs below, and their rows are written in this order.
+
+        struct Job {
+            AlgorithmBase *algo;
+            int b;
+            std::ostringstream output;
+            bool done = false;
+            bool success = false;
+            bool consistent = true;
+        };
+        std::vector<Job> jobs(config->all_bs.size() * instances[0].size());
+        for (std::size_t i = 0; i < jobs.size(); i++) {
+            jobs[i].algo = instances[i / instances[0].size()][i % instances[0].size()].get();
+            jobs[i].b = config->all_bs[i / instances[0].size()];
+        }
+
+        // Each worker replays the trace through a cursor of its own
+        const auto num_workers = std::min<std::size_t>(config->threads, jobs.size());
+        std::vector<std::unique_ptr<DeltaSource>> sources;
+        std::vector<ReplayStats> worker_stats(num_workers);
+        std::vector<WindowedDeltaSource*> worker_windows(num_workers, nullptr);
+        for (std::size_t i = 0; i < num_workers; i++) {
+            sources.push_back(make_source(&worker_windows[i]));
+        }
+        std::atomic<std::size_t> next_job{0};
+        std::mutex mutex;
+        std::condition_variable job_done;
+        std::vector<std::thread> workers;
+        for (std::size_t w = 0; w < num_workers; w++) {
+            workers.emplace_back([&, w]() {
+                for (auto i = next_job++; i < jobs.size(); i = next_job++) {
+                    ResultTable job_table(result_columns, jobs[i].output, results_format);
+                    bool success = replay_repeated({jobs[i].algo}, {jobs[i].b}, *config, *sources[w], firstDelta,
+                                                   startState, job_table, worker_stats[w], jobs[i].consistent,
+                                                   diffs ? &*diffs : nullptr);
+                    job_table.flush();
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        jobs[i].done = true;
+                        jobs[i].success = success;
+                    }
+                    job_done.notify_all();
+                }
+            });
+        }
+        bool success = true;
+        for (auto &job: jobs) {
+            std::unique_lock<std::mutex> lock(mutex);
+            job_done.wait(lock, [&job]() { return job.done; });
+            lock.unlock();
+            success = success && job.success;
+            consistent = consistent && job.consistent;
+            table.addText(job.output.str());
+            job.output = std::ostringstream();
+        }
+        for (auto &worker: workers) {
+            worker.join();
+        }
+        if (!success) {
+            std::cerr << "Error reading " << graph_filename << std::endl;
+            return 1;
+        }
+        for (std::size_t i = 0; i < num_workers; i++) {
+            stats.coalescer.add(worker_stats[i].coalescer);
+            stats.io_time += worker_stats[i].io_time;
+            if (worker_stats[i].windows > 0) {
+                stats.windows = worker_stats[i].windows;
+                windows = worker_windows[i];
+            }
+            decompression_seconds += sources[i]->decompression_time();
+        }
+    } else {
+        // Run `run_algos` with `b`, in a child process of its own if requested.
+        // The child inherits the loaded trace and reports its rows and peak memory usage.
+        auto replay = [&](const std::vector<AlgorithmBase*> &run_algos, const std::vector<int> &bs) {
+            if (!config->isolate_runs) {
+                return replay_repeated(run_algos, bs, *config, *delta_source, firstDelta, startState,
+                                       table, stats, consistent, diffs ? &*diffs : nullptr);
+            }
+            IsolatedRunReport report;
+            std::string rows;
+            long peak_rss_kb = 0;
+            bool started = run_isolated([&](std::ostream &stream) {
+                // The source of this process may prefetch on a thread, which does not exist in the child
+                WindowedDeltaSource *child_windows = nullptr;
+                auto source = make_source(&child_windows);
+                ReplayStats child_stats;
+                ResultTable child_table(result_columns, stream, results_format);
+                IsolatedRunReport child_report{};
+                child_report.consistent = true;
+                child_report.success = replay_repeated(run_algos, bs, *config, *source, firstDelta, startState,
+                                                       child_table, child_stats, child_report.consistent);
+                child_report.io_time = child_stats.io_time;
+                child_report.windows = child_stats.windows;
+                child_report.grouped_timestamps = child_windows ? child_windows->deltas_read() : 0;
+                child_report.total_updates = child_stats.coalescer.total_updates();
+                child_report.remaining_updates = child_stats.coalescer.remaining_updates();
+                child_report.shared_delta_time = child_stats.shared_delta_time;
+                child_report.decompression_time = source->decompression_time();
+                return child_report;
+            }, report, rows, peak_rss_kb);
+            if (!started) {
+                return false;
+            }
+            // Write the rows before reporting the run, in case both go to standard output
+            table.addText(std::move(rows));
+            table.flush();
+            consistent = consistent && report.consistent;
+            stats.io_time += report.io_time;
+            stats.windows = report.windows;
+            stats.coalescer.add(report.total_updates, report.remaining_updates);
+            stats.shared_delta_time += report.shared_delta_time;
+            decompression_seconds += report.decompression_time;
+            isolated_timestamps = report.grouped_timestamps;
+            std::cout << "Peak RSS of";
+            for (std::size_t i = 0; i < run_algos.size(); i++) {
+                std::cout << " " << run_algos[i]->getName() << " (b = " << bs[i] << ")";
+            }
+            std::cout << ": " << peak_rss_kb << " kB\n";
+            return report.success;
+        };
+
+        if (config->shared_b) {
+            // Replay the trace once for all b, either per algorithm or for all algorithms.
+            // The instances of an algorithm for all b share the graph and the order of its arcs by weight.
+            // An algorithm with nested solutions computes them for all b in its instance for the largest b.
+            const auto num_groups = config->single_pass ? 1 : instances[0].size();
+            const auto largest_b = static_cast<std::size_t>(
+                    std::max_element(config->all_bs.begin(), config->all_bs.end()) - config->all_bs.begin());
+            std::vector<std::vector<AlgorithmBase*>> shared_algos(num_groups);
+            std::vector<std::vector<int>> shared_bs(num_groups);
+            for (std::size_t i = 0; i < instances.size(); i++) {
+                for (std::size_t j = 0; j < instances[i].size(); j++) {
+                    if (instances[i][j]->nests_solutions()) {
+                        if (i != largest_b) {
+                            continue;
+                        }
+                        instances[i][j]->set_nested_bs(config->all_bs);
+                    }
+                    shared_algos[config->single_pass ? 0 : j].push_back(instances[i][j].get());
+                    shared_bs[config->single_pass ? 0 : j].push_back(config->all_bs[i]);
+                }
+            }
+            for (std::size_t i = 0; i < shared_algos.size(); i++) {
+                if (!replay(shared_algos[i], shared_bs[i])) {
+                    std::cerr << "Error reading " << graph_filename << std::endl;
+                    return 1;
+                }
+            }
+        } else {
+            // Run one (b, algorithm) pair after the other
+            ChronoTimer deltaTimer;
+            for (auto b: config->all_bs) {
+                config->b = b;
+                if (config->single_pass) {
+                    // Replay the trace once for all algorithms
+                    std::vector<AlgorithmBase*> all_algos;
+                    for (auto &algo: algos) {
+                        all_algos.push_back(algo.get());
+                    }
+                    if (!replay(all_algos, std::vector<int>(all_algos.size(), b))) {
+                        std::cerr << "Error reading " << graph_filename << std::endl;
+                        return 1;
+                    }
+                    continue;
+                }
+                for (auto &algo: algos) {
+                    if (delta_source) {
+                        // Re-open the trace (or rewind the in-memory log) and build the graph from scratch
+                        if (!replay({algo.get()}, {b})) {
+                            std::cerr << "Error reading " << graph_filename << std::endl;
+                            return 1;
+                        }
+                        continue;
+                    }
+
+                    G.resetToBigBang();
+                    weights->resetAll();
+                    algo->setGraph(diGraph);
+                    algo->setWeights(weights);
+                    algo->set_num_matchings(b);
+                    algo->init();
+                    int delta_counter = 0;
+                    deltaTimer.restart();
+                    while(G.applyNextDelta()) {
+                        delta_counter++;
+                        auto deltaTime = deltaTimer.elapsed<>(); // Measure time of 'applyNextDelta()'
+                        run_delta(algo.get(), b, delta_counter, deltaTime, diGraph, G.getSizeOfLastDelta(),
+                                  nullptr, table);
+                        deltaTimer.restart();
+                    }
+                    algo->unsetGraph();
+                    algo->unsetWeights();
+                }
+            }
+        }
+        if (delta_source) {
+            decompression_seconds += delta_source->decompression_time();
+        }
+    }
+    table.flush();
+    if (diffs && !diffs->close()) {
+        std::cout << "Error! Could not write file " << config->diff_output_file << "\n";
+        return 1;
+    }
+    if (windows) {
+        auto timestamps = config->isolate_runs ? isolated_timestamps : windows->deltas_read();
+        std::cout << "Grouped " << timestamps << " timestamps into " << stats.windows << " windows\n";
+    }
+    if (config->coalesce_updates) {
+        std::cout << "Coalescing kept " << stats.coalescer.remaining_updates() << " of "
+                  << stats.coalescer.total_updates() << " updates\n";
+    }
+    if (config->single_pass || config->shared_b) {
+        std::cout << "Applying deltas outside of algorithms took " << stats.shared_delta_time << "s\n";
+    }
+    if (config->stream_input) {
+        std::cout << "Input I/O took " << stats.io_time << "s\n";
+        if (compression_of(graph_filename) != Compression::NONE) {
+            std::cout << "Decompression took " << decompression_seconds << "s\n";
         }
     }
 
-    output_stream.flush();
     output_stream.rdbuf(nullptr);
 
-    return 0;
+    return consistent ? 0 : 1;
 }
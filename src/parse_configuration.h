@@ -20,8 +20,12 @@
  *   https://github.com/DJ-Match/DyDJ-Match
  */
 
+#include <algorithm>
+#include <functional>
 #include <iostream>
 #include <memory>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "algorithm/disjoint_matching_algorithm.h"
@@ -36,14 +40,23 @@
 #include "tools/analysis_algo.h"
 #include "tools/edge_ranking_analysis_algo.h"
 
+// Values of b for which the algorithms using mates and free colors are compiled with a fixed
+// number of colors, separated by commas (see `FIXED_COLORS` in CMakeLists.txt).
+#ifndef DYDJ_FIXED_COLORS
+    #define DYDJ_FIXED_COLORS 4, 8, 16
+#endif
+
 class ConfigReader {
 
 public:
+    // Messages about the algorithms and options read are written to `log`, errors to the standard streams.
     inline ConfigReader(MatchingConfig &config,
                         std::istream &input,
-                        std::vector<std::unique_ptr<AlgorithmBase>> &algos) : config(config),
-                                                                              input(input),
-                                                                              algos(algos) {}
+                        std::vector<std::unique_ptr<AlgorithmBase>> &algos,
+                        std::ostream &log = std::cout) : config(config),
+                                                         input(input),
+                                                         algos(algos),
+                                                         log(log) {}
 
 private:
     static constexpr auto no_update_strategy_name = "none";
@@ -54,9 +67,16 @@ private:
     MatchingConfig &config;
     std::istream &input;
     std::vector<std::unique_ptr<AlgorithmBase>> &algos;
+    std::ostream &log;
     std::string update_strategy_name = "none";
     std::array<std::string, 2> update_strategy_params;
 
+    // Number of colors that algorithms have been instantiated with at compile time, 0 if none
+    color_t instantiated_fixed_colors = 0;
+    // For each algorithm with colors fixed at compile time, its index in `algos`
+    // and how to construct it with a runtime number of colors instead
+    std::vector<std::pair<std::size_t, std::function<AlgorithmBase*()>>> runtime_colors_fallbacks;
+
     // Reading a value of type T from an input stream
     // If no value can be read, that's a failure
     template<class T>
@@ -79,6 +99,55 @@ private:
     }
 
     // Read algorithm parameters from an input stream
+    // Number of colors to fix at compile time: the configured `b` if it is the only one so far and one of `Ks`,
+    // otherwise 0 for a runtime number of colors.
+    template<color_t... Ks>
+    color_t fixed_colors() const {
+        if (config.all_bs.empty()) {
+            return 0;
+        }
+        auto b = config.all_bs.front();
+        if (std::any_of(config.all_bs.begin(), config.all_bs.end(), [b](auto other) { return other != b; })) {
+            return 0;
+        }
+        return ((b == Ks) || ...) ? b : 0;
+    }
+
+    // Add the algorithm constructed by `make(std::integral_constant<color_t, K>{})`,
+    // where `K` is the number of colors to fix at compile time (see `fixed_colors()`) among `DYDJ_FIXED_COLORS`.
+    template<typename Make>
+    std::unique_ptr<AlgorithmBase>& emplace_with_fixed_colors(Make make) {
+        return emplace_with_fixed_colors_among<DYDJ_FIXED_COLORS>(make);
+    }
+
+    template<color_t... Ks, typename Make>
+    std::unique_ptr<AlgorithmBase>& emplace_with_fixed_colors_among(Make make) {
+        auto k = fixed_colors<Ks...>();
+        std::unique_ptr<AlgorithmBase> *added = nullptr;
+        ((k == Ks && (added = &emplace_fixed(make, std::integral_constant<color_t, Ks>{}))) || ...);
+        return added != nullptr ? *added : algos.emplace_back(make(std::integral_constant<color_t, 0>{}));
+    }
+
+    template<typename Make, color_t K>
+    std::unique_ptr<AlgorithmBase>& emplace_fixed(Make make, std::integral_constant<color_t, K> k) {
+        instantiated_fixed_colors = K;
+        runtime_colors_fallbacks.emplace_back(algos.size(), [make]() { return make(std::integral_constant<color_t, 0>{}); });
+        return algos.emplace_back(make(k));
+    }
+
+    // If a `b` other than the one that algorithms have been instantiated with at compile time is configured,
+    // replace these algorithms by ones with a runtime number of colors
+    void use_runtime_colors_if_needed() {
+        if (instantiated_fixed_colors == 0 || config.b == instantiated_fixed_colors) {
+            return;
+        }
+        for (auto &[index, make]: runtime_colors_fallbacks) {
+            algos[index].reset(make());
+        }
+        runtime_colors_fallbacks.clear();
+        instantiated_fixed_colors = 0;
+    }
+
     bool make_greedy() {
         bool swaps;
         if (read_many(swaps)) {
@@ -207,8 +276,8 @@ private:
                         algos.emplace_back(new KEdgeColoring_2<type, cc, mr, count_ops, !imp_pp>(post_process, thresh, filter_thresh));
                 } else {
                     improved_pp ?
-                        algos.emplace_back(new KEdgeColoring_2<type, cc, mr, !count_ops, imp_pp>(post_process, thresh, filter_thresh)) :
-                        algos.emplace_back(new KEdgeColoring_2<type, cc, mr, !count_ops, !imp_pp>(post_process, thresh, filter_thresh));
+                        emplace_with_fixed_colors([=](auto k) -> AlgorithmBase* { return new KEdgeColoring_2<type, cc, mr, !count_ops, imp_pp, decltype(k)::value>(post_process, thresh, filter_thresh); }) :
+                        emplace_with_fixed_colors([=](auto k) -> AlgorithmBase* { return new KEdgeColoring_2<type, cc, mr, !count_ops, !imp_pp, decltype(k)::value>(post_process, thresh, filter_thresh); });
                 }
             } else {
                 if (config.count_coloring_ops) {
@@ -217,8 +286,8 @@ private:
                         algos.emplace_back(new KEdgeColoring_2<type, cc, !mr, count_ops, !imp_pp>(post_process, thresh, filter_thresh));
                 } else {
                     improved_pp ?
-                        algos.emplace_back(new KEdgeColoring_2<type, cc, !mr, !count_ops, imp_pp>(post_process, thresh, filter_thresh)) :
-                        algos.emplace_back(new KEdgeColoring_2<type, cc, !mr, !count_ops, !imp_pp>(post_process, thresh, filter_thresh));
+                        emplace_with_fixed_colors([=](auto k) -> AlgorithmBase* { return new KEdgeColoring_2<type, cc, !mr, !count_ops, imp_pp, decltype(k)::value>(post_process, thresh, filter_thresh); }) :
+                        emplace_with_fixed_colors([=](auto k) -> AlgorithmBase* { return new KEdgeColoring_2<type, cc, !mr, !count_ops, !imp_pp, decltype(k)::value>(post_process, thresh, filter_thresh); });
                 }
             }
         } else {
@@ -229,8 +298,8 @@ private:
                         algos.emplace_back(new KEdgeColoring_2<type, !cc, mr, count_ops, !imp_pp>(post_process, thresh, filter_thresh));
                 } else {
                     improved_pp ?
-                        algos.emplace_back(new KEdgeColoring_2<type, !cc, mr, !count_ops, imp_pp>(post_process, thresh, filter_thresh)) :
-                        algos.emplace_back(new KEdgeColoring_2<type, !cc, mr, !count_ops, !imp_pp>(post_process, thresh, filter_thresh));
+                        emplace_with_fixed_colors([=](auto k) -> AlgorithmBase* { return new KEdgeColoring_2<type, !cc, mr, !count_ops, imp_pp, decltype(k)::value>(post_process, thresh, filter_thresh); }) :
+                        emplace_with_fixed_colors([=](auto k) -> AlgorithmBase* { return new KEdgeColoring_2<type, !cc, mr, !count_ops, !imp_pp, decltype(k)::value>(post_process, thresh, filter_thresh); });
                 }
             } else {
                 if (config.count_coloring_ops) {
@@ -239,8 +308,8 @@ private:
                         algos.emplace_back(new KEdgeColoring_2<type, !cc, !mr, count_ops, !imp_pp>(post_process, thresh, filter_thresh));
                 } else {
                     improved_pp ?
-                        algos.emplace_back(new KEdgeColoring_2<type, !cc, !mr, !count_ops, imp_pp>(post_process, thresh, filter_thresh)) :
-                        algos.emplace_back(new KEdgeColoring_2<type, !cc, !mr, !count_ops, !imp_pp>(post_process, thresh, filter_thresh));
+                        emplace_with_fixed_colors([=](auto k) -> AlgorithmBase* { return new KEdgeColoring_2<type, !cc, !mr, !count_ops, imp_pp, decltype(k)::value>(post_process, thresh, filter_thresh); }) :
+                        emplace_with_fixed_colors([=](auto k) -> AlgorithmBase* { return new KEdgeColoring_2<type, !cc, !mr, !count_ops, !imp_pp, decltype(k)::value>(post_process, thresh, filter_thresh); });
                 }
             }
         }
@@ -294,37 +363,37 @@ private:
                 if (random == 3) {
                     config.count_coloring_ops ?
                         algos.emplace_back(new DynamicGreedy<true, true, 3>(num_retries, post_process, filter_threshold)) :
-                        algos.emplace_back(new DynamicGreedy<false, true, 3>(num_retries, post_process, filter_threshold));
+                        emplace_with_fixed_colors([=](auto k) -> AlgorithmBase* { return new DynamicGreedy<false, true, 3, decltype(k)::value>(num_retries, post_process, filter_threshold); });
                 } else if (random == 2) {
                     config.count_coloring_ops ?
                         algos.emplace_back(new DynamicGreedy<true, true, 2>(num_retries, post_process, filter_threshold)) :
-                        algos.emplace_back(new DynamicGreedy<false, true, 2>(num_retries, post_process, filter_threshold));
+                        emplace_with_fixed_colors([=](auto k) -> AlgorithmBase* { return new DynamicGreedy<false, true, 2, decltype(k)::value>(num_retries, post_process, filter_threshold); });
                 } else if (random == 1) {
                     config.count_coloring_ops ?
                         algos.emplace_back(new DynamicGreedy<true, true, 1>(num_retries, post_process, filter_threshold)) :
-                        algos.emplace_back(new DynamicGreedy<false, true, 1>(num_retries, post_process, filter_threshold));
+                        emplace_with_fixed_colors([=](auto k) -> AlgorithmBase* { return new DynamicGreedy<false, true, 1, decltype(k)::value>(num_retries, post_process, filter_threshold); });
                 } else {
                     config.count_coloring_ops ?
                         algos.emplace_back(new DynamicGreedy<true, true, 0>(num_retries, post_process, filter_threshold)) :
-                        algos.emplace_back(new DynamicGreedy<false, true, 0>(num_retries, post_process, filter_threshold));
+                        emplace_with_fixed_colors([=](auto k) -> AlgorithmBase* { return new DynamicGreedy<false, true, 0, decltype(k)::value>(num_retries, post_process, filter_threshold); });
                 }
             } else if (improved_processing == '-') {
                 if (random == 3) {
                     config.count_coloring_ops ?
                         algos.emplace_back(new DynamicGreedy<true, false, 3>(num_retries, post_process, filter_threshold)) :
-                        algos.emplace_back(new DynamicGreedy<false, false, 3>(num_retries, post_process, filter_threshold));
+                        emplace_with_fixed_colors([=](auto k) -> AlgorithmBase* { return new DynamicGreedy<false, false, 3, decltype(k)::value>(num_retries, post_process, filter_threshold); });
                 } else if (random == 2) {
                     config.count_coloring_ops ?
                         algos.emplace_back(new DynamicGreedy<true, false, 2>(num_retries, post_process, filter_threshold)) :
-                        algos.emplace_back(new DynamicGreedy<false, false, 2>(num_retries, post_process, filter_threshold));
+                        emplace_with_fixed_colors([=](auto k) -> AlgorithmBase* { return new DynamicGreedy<false, false, 2, decltype(k)::value>(num_retries, post_process, filter_threshold); });
                 } else if (random == 1) {
                     config.count_coloring_ops ?
                         algos.emplace_back(new DynamicGreedy<true, false, 1>(num_retries, post_process, filter_threshold)) :
-                        algos.emplace_back(new DynamicGreedy<false, false, 1>(num_retries, post_process, filter_threshold));
+                        emplace_with_fixed_colors([=](auto k) -> AlgorithmBase* { return new DynamicGreedy<false, false, 1, decltype(k)::value>(num_retries, post_process, filter_threshold); });
                 } else {
                     config.count_coloring_ops ?
                         algos.emplace_back(new DynamicGreedy<true, false, 0>(num_retries, post_process, filter_threshold)) :
-                        algos.emplace_back(new DynamicGreedy<false, false, 0>(num_retries, post_process, filter_threshold));
+                        emplace_with_fixed_colors([=](auto k) -> AlgorithmBase* { return new DynamicGreedy<false, false, 0, decltype(k)::value>(num_retries, post_process, filter_threshold); });
                 }
             } else {
                 return false;
@@ -354,21 +423,21 @@ private:
                         if (random > 0) {
                             config.count_coloring_ops ?
                                 algos.emplace_back(new DynGreedyKEdgeColoringHybrid<cc, rl,  count_ops,  imp_pp,  randomize>(post_process, hybrid_threshold, num_retries, random, filter_threshold)) :
-                                algos.emplace_back(new DynGreedyKEdgeColoringHybrid<cc, rl, !count_ops,  imp_pp,  randomize>(post_process, hybrid_threshold, num_retries, random, filter_threshold));
+                                emplace_with_fixed_colors([=](auto k) -> AlgorithmBase* { return new DynGreedyKEdgeColoringHybrid<cc, rl, !count_ops,  imp_pp,  randomize, decltype(k)::value>(post_process, hybrid_threshold, num_retries, random, filter_threshold); });
                         } else {
                             config.count_coloring_ops ?
                                 algos.emplace_back(new DynGreedyKEdgeColoringHybrid<cc, rl,  count_ops,  imp_pp, !randomize>(post_process, hybrid_threshold, num_retries, random, filter_threshold)) :
-                                algos.emplace_back(new DynGreedyKEdgeColoringHybrid<cc, rl, !count_ops,  imp_pp, !randomize>(post_process, hybrid_threshold, num_retries, random, filter_threshold));
+                                emplace_with_fixed_colors([=](auto k) -> AlgorithmBase* { return new DynGreedyKEdgeColoringHybrid<cc, rl, !count_ops,  imp_pp, !randomize, decltype(k)::value>(post_process, hybrid_threshold, num_retries, random, filter_threshold); });
                         }
                     } else {
                         if (random > 0) {
                             config.count_coloring_ops ?
                                 algos.emplace_back(new DynGreedyKEdgeColoringHybrid<cc, rl,  count_ops, !imp_pp,  randomize>(post_process, hybrid_threshold, num_retries, random, filter_threshold)) :
-                                algos.emplace_back(new DynGreedyKEdgeColoringHybrid<cc, rl, !count_ops, !imp_pp,  randomize>(post_process, hybrid_threshold, num_retries, random, filter_threshold));
+                                emplace_with_fixed_colors([=](auto k) -> AlgorithmBase* { return new DynGreedyKEdgeColoringHybrid<cc, rl, !count_ops, !imp_pp,  randomize, decltype(k)::value>(post_process, hybrid_threshold, num_retries, random, filter_threshold); });
                         } else {
                             config.count_coloring_ops ?
                                 algos.emplace_back(new DynGreedyKEdgeColoringHybrid<cc, rl,  count_ops, !imp_pp, !randomize>(post_process, hybrid_threshold, num_retries, random, filter_threshold)) :
-                                algos.emplace_back(new DynGreedyKEdgeColoringHybrid<cc, rl, !count_ops, !imp_pp, !randomize>(post_process, hybrid_threshold, num_retries, random, filter_threshold));
+                                emplace_with_fixed_colors([=](auto k) -> AlgorithmBase* { return new DynGreedyKEdgeColoringHybrid<cc, rl, !count_ops, !imp_pp, !randomize, decltype(k)::value>(post_process, hybrid_threshold, num_retries, random, filter_threshold); });
                         }
                     }
                 } else {
@@ -376,21 +445,21 @@ private:
                         if (random > 0) {
                             config.count_coloring_ops ?
                                 algos.emplace_back(new DynGreedyKEdgeColoringHybrid<cc, !rl,  count_ops,  imp_pp,  randomize>(post_process, hybrid_threshold, num_retries, random, filter_threshold)) :
-                                algos.emplace_back(new DynGreedyKEdgeColoringHybrid<cc, !rl, !count_ops,  imp_pp,  randomize>(post_process, hybrid_threshold, num_retries, random, filter_threshold));
+                                emplace_with_fixed_colors([=](auto k) -> AlgorithmBase* { return new DynGreedyKEdgeColoringHybrid<cc, !rl, !count_ops,  imp_pp,  randomize, decltype(k)::value>(post_process, hybrid_threshold, num_retries, random, filter_threshold); });
                         } else {
                             config.count_coloring_ops ?
                                 algos.emplace_back(new DynGreedyKEdgeColoringHybrid<cc, !rl,  count_ops,  imp_pp, !randomize>(post_process, hybrid_threshold, num_retries, random, filter_threshold)) :
-                                algos.emplace_back(new DynGreedyKEdgeColoringHybrid<cc, !rl, !count_ops,  imp_pp, !randomize>(post_process, hybrid_threshold, num_retries, random, filter_threshold));
+                                emplace_with_fixed_colors([=](auto k) -> AlgorithmBase* { return new DynGreedyKEdgeColoringHybrid<cc, !rl, !count_ops,  imp_pp, !randomize, decltype(k)::value>(post_process, hybrid_threshold, num_retries, random, filter_threshold); });
                         }
                     } else {
                         if (random > 0) {
                             config.count_coloring_ops ?
                                 algos.emplace_back(new DynGreedyKEdgeColoringHybrid<cc, !rl,  count_ops, !imp_pp,  randomize>(post_process, hybrid_threshold, num_retries, random, filter_threshold)) :
-                                algos.emplace_back(new DynGreedyKEdgeColoringHybrid<cc, !rl, !count_ops, !imp_pp,  randomize>(post_process, hybrid_threshold, num_retries, random, filter_threshold));
+                                emplace_with_fixed_colors([=](auto k) -> AlgorithmBase* { return new DynGreedyKEdgeColoringHybrid<cc, !rl, !count_ops, !imp_pp,  randomize, decltype(k)::value>(post_process, hybrid_threshold, num_retries, random, filter_threshold); });
                         } else {
                             config.count_coloring_ops ?
                                 algos.emplace_back(new DynGreedyKEdgeColoringHybrid<cc, !rl,  count_ops, !imp_pp, !randomize>(post_process, hybrid_threshold, num_retries, random, filter_threshold)) :
-                                algos.emplace_back(new DynGreedyKEdgeColoringHybrid<cc, !rl, !count_ops, !imp_pp, !randomize>(post_process, hybrid_threshold, num_retries, random, filter_threshold));
+                                emplace_with_fixed_colors([=](auto k) -> AlgorithmBase* { return new DynGreedyKEdgeColoringHybrid<cc, !rl, !count_ops, !imp_pp, !randomize, decltype(k)::value>(post_process, hybrid_threshold, num_retries, random, filter_threshold); });
                         }
                     }
                 }
@@ -400,21 +469,21 @@ private:
                         if (random > 0) {
                             config.count_coloring_ops ?
                                 algos.emplace_back(new DynGreedyKEdgeColoringHybrid<!cc, rl,  count_ops,  imp_pp,  randomize>(post_process, hybrid_threshold, num_retries, random, filter_threshold)) :
-                                algos.emplace_back(new DynGreedyKEdgeColoringHybrid<!cc, rl, !count_ops,  imp_pp,  randomize>(post_process, hybrid_threshold, num_retries, random, filter_threshold));
+                                emplace_with_fixed_colors([=](auto k) -> AlgorithmBase* { return new DynGreedyKEdgeColoringHybrid<!cc, rl, !count_ops,  imp_pp,  randomize, decltype(k)::value>(post_process, hybrid_threshold, num_retries, random, filter_threshold); });
                         } else {
                             config.count_coloring_ops ?
                                 algos.emplace_back(new DynGreedyKEdgeColoringHybrid<!cc, rl,  count_ops,  imp_pp, !randomize>(post_process, hybrid_threshold, num_retries, random, filter_threshold)) :
-                                algos.emplace_back(new DynGreedyKEdgeColoringHybrid<!cc, rl, !count_ops,  imp_pp, !randomize>(post_process, hybrid_threshold, num_retries, random, filter_threshold));
+                                emplace_with_fixed_colors([=](auto k) -> AlgorithmBase* { return new DynGreedyKEdgeColoringHybrid<!cc, rl, !count_ops,  imp_pp, !randomize, decltype(k)::value>(post_process, hybrid_threshold, num_retries, random, filter_threshold); });
                         }
                     } else {
                         if (random > 0) {
                             config.count_coloring_ops ?
                                 algos.emplace_back(new DynGreedyKEdgeColoringHybrid<!cc, rl,  count_ops, !imp_pp,  randomize>(post_process, hybrid_threshold, num_retries, random, filter_threshold)) :
-                                algos.emplace_back(new DynGreedyKEdgeColoringHybrid<!cc, rl, !count_ops, !imp_pp,  randomize>(post_process, hybrid_threshold, num_retries, random, filter_threshold));
+                                emplace_with_fixed_colors([=](auto k) -> AlgorithmBase* { return new DynGreedyKEdgeColoringHybrid<!cc, rl, !count_ops, !imp_pp,  randomize, decltype(k)::value>(post_process, hybrid_threshold, num_retries, random, filter_threshold); });
                         } else {
                             config.count_coloring_ops ?
                                 algos.emplace_back(new DynGreedyKEdgeColoringHybrid<!cc, rl,  count_ops, !imp_pp, !randomize>(post_process, hybrid_threshold, num_retries, random, filter_threshold)) :
-                                algos.emplace_back(new DynGreedyKEdgeColoringHybrid<!cc, rl, !count_ops, !imp_pp, !randomize>(post_process, hybrid_threshold, num_retries, random, filter_threshold));
+                                emplace_with_fixed_colors([=](auto k) -> AlgorithmBase* { return new DynGreedyKEdgeColoringHybrid<!cc, rl, !count_ops, !imp_pp, !randomize, decltype(k)::value>(post_process, hybrid_threshold, num_retries, random, filter_threshold); });
                         }
                     }
                 } else {
@@ -422,21 +491,21 @@ private:
                         if (random > 0) {
                             config.count_coloring_ops ?
                                 algos.emplace_back(new DynGreedyKEdgeColoringHybrid<!cc, !rl,  count_ops,  imp_pp,  randomize>(post_process, hybrid_threshold, num_retries, random, filter_threshold)) :
-                                algos.emplace_back(new DynGreedyKEdgeColoringHybrid<!cc, !rl, !count_ops,  imp_pp,  randomize>(post_process, hybrid_threshold, num_retries, random, filter_threshold));
+                                emplace_with_fixed_colors([=](auto k) -> AlgorithmBase* { return new DynGreedyKEdgeColoringHybrid<!cc, !rl, !count_ops,  imp_pp,  randomize, decltype(k)::value>(post_process, hybrid_threshold, num_retries, random, filter_threshold); });
                         } else {
                             config.count_coloring_ops ?
                                 algos.emplace_back(new DynGreedyKEdgeColoringHybrid<!cc, !rl,  count_ops,  imp_pp, !randomize>(post_process, hybrid_threshold, num_retries, random, filter_threshold)) :
-                                algos.emplace_back(new DynGreedyKEdgeColoringHybrid<!cc, !rl, !count_ops,  imp_pp, !randomize>(post_process, hybrid_threshold, num_retries, random, filter_threshold));
+                                emplace_with_fixed_colors([=](auto k) -> AlgorithmBase* { return new DynGreedyKEdgeColoringHybrid<!cc, !rl, !count_ops,  imp_pp, !randomize, decltype(k)::value>(post_process, hybrid_threshold, num_retries, random, filter_threshold); });
                         }
                     } else {
                         if (random > 0) {
                             config.count_coloring_ops ?
                                 algos.emplace_back(new DynGreedyKEdgeColoringHybrid<!cc, !rl,  count_ops, !imp_pp,  randomize>(post_process, hybrid_threshold, num_retries, random, filter_threshold)) :
-                                algos.emplace_back(new DynGreedyKEdgeColoringHybrid<!cc, !rl, !count_ops, !imp_pp,  randomize>(post_process, hybrid_threshold, num_retries, random, filter_threshold));
+                                emplace_with_fixed_colors([=](auto k) -> AlgorithmBase* { return new DynGreedyKEdgeColoringHybrid<!cc, !rl, !count_ops, !imp_pp,  randomize, decltype(k)::value>(post_process, hybrid_threshold, num_retries, random, filter_threshold); });
                         } else {
                             config.count_coloring_ops ?
                                 algos.emplace_back(new DynGreedyKEdgeColoringHybrid<!cc, !rl,  count_ops, !imp_pp, !randomize>(post_process, hybrid_threshold, num_retries, random, filter_threshold)) :
-                                algos.emplace_back(new DynGreedyKEdgeColoringHybrid<!cc, !rl, !count_ops, !imp_pp, !randomize>(post_process, hybrid_threshold, num_retries, random, filter_threshold));
+                                emplace_with_fixed_colors([=](auto k) -> AlgorithmBase* { return new DynGreedyKEdgeColoringHybrid<!cc, !rl, !count_ops, !imp_pp, !randomize, decltype(k)::value>(post_process, hybrid_threshold, num_retries, random, filter_threshold); });
                         }
                     }
                 }
@@ -466,7 +535,7 @@ private:
     bool make_invariant_greedy() {
         config.count_coloring_ops ?
             algos.emplace_back(new InvariantGreedy<true>()) :
-            algos.emplace_back(new InvariantGreedy<false>());
+            emplace_with_fixed_colors([=](auto k) -> AlgorithmBase* { return new InvariantGreedy<false, decltype(k)::value>(); });
         return true;
     }
 
@@ -503,7 +572,7 @@ private:
             std::cerr << "Invalid algorithm '" << algo_name << "'!" << std::endl;
             return false;
         }
-        std::cout << "Algorithm " << algo_name << std::endl;
+        log << "Algorithm " << algo_name << std::endl;
         return success;
     }
 
@@ -520,32 +589,44 @@ public:
                 success = readAlgo();
             } else if (config_str == "b") {
                 success = read_one<unsigned>(config.b);
+                if (success && config.b > color_set::max_colors) {
+                    std::cerr << "b = " << config.b << " exceeds the maximum number of colors "
+                              << color_set::max_colors << ", see MAX_COLORS in CMakeLists.txt" << std::endl;
+                    success = false;
+                }
                 config.all_bs.push_back(config.b);
-                std::cout << "b[" << config.all_bs.size() << "] = " << config.b << std::endl;
+                use_runtime_colors_if_needed();
+                log << "b[" << config.all_bs.size() << "] = " << config.b << std::endl;
             } else if (config_str == "sanitycheck") {
                 config.sanitycheck = true;
-                std::cout << "Sanity check is enabled" << std::endl;
+                log << "Sanity check is enabled" << std::endl;
             } else if (config_str == "console_log") {
                 config.console_log = true;
-                std::cout << "Logging is enabled" << std::endl;
+                log << "Logging is enabled" << std::endl;
             } else if (config_str == "seed") {
                 success = read_one<int>(config.seed);
-                std::cout << "Random seed: " << config.seed << std::endl;
+                log << "Random seed: " << config.seed << std::endl;
             } else if (config_str == "algorithm_order_seed") {
                 success = read_one<unsigned>(config.algorithm_order_seed);
-                std::cout << "Seed for random algorithm order: " << config.algorithm_order_seed << std::endl;
+                log << "Seed for random algorithm order: " << config.algorithm_order_seed << std::endl;
+            } else if (config_str == "repeat") {
+                success = read_one<unsigned>(config.repeat) && config.repeat > 0;
+                log << "Repetitions per run: " << config.repeat << std::endl;
+            } else if (config_str == "warmup") {
+                success = read_one<unsigned>(config.warmup);
+                log << "Warm-up runs: " << config.warmup << std::endl;
             } else if (config_str == "count_color_ops") {
                 config.count_coloring_ops = true;
                 success = true;
-                std::cout << "Counting coloring operations is enabled." << std::endl;
+                log << "Counting coloring operations is enabled." << std::endl;
             } else if (config_str == "analysis") {
                 algos.emplace_back(new AnalysisAlgo());
                 success = true;
-                std::cout << "Analysis enabled." << std::endl;
+                log << "Analysis enabled." << std::endl;
             } else if (config_str == "ranking_analysis") {
                 algos.emplace_back(new RankingAnalysisAlgo());
                 success = true;
-                std::cout << "Analysing edge rankings." << std::endl;
+                log << "Analysing edge rankings." << std::endl;
             } else {
                 std::cout << "Unknown option " << config_str << std::endl;
                 return false;
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <iostream>
 #include <string>
 #include <sstream>
 
@@ -35,6 +36,20 @@ std::string base_name(std::string const & path) {
   return path.substr(path.find_last_of("/\\") + 1);
 }
 
+// Whether the trace has to be replayed through a `DeltaSource` rather than by Algora's dynamic graph,
+// i.e., whether any option is set that transforms the deltas or runs the algorithms in another way
+// than one after the other on the original trace.
+// Without `--stream`, the trace is then kept in memory as an `UpdateLog`.
+inline bool needs_own_delta_handling(const MatchingConfig &config) {
+    const bool transforms_deltas = config.vertex_order != VertexOrder::NONE || config.start_delta > 0 ||
+            config.start_timestamp || config.coalesce_updates || config.window_span > 0 ||
+            config.window_updates > 0 || config.decay_half_life > 0 || config.bulk_init;
+    const bool schedules_runs = config.prefetch_deltas || config.threads > 1 || config.single_pass ||
+            config.shared_b || config.repeat > 1 || config.warmup > 0 || config.isolate_runs;
+    const bool records_runs = !config.capture_events_file.empty() || !config.diff_output_file.empty();
+    return config.stream_input || transforms_deltas || schedules_runs || records_runs;
+}
+
 int parse_matching_parameters(int argn, char **argv,  MatchingConfig &matching_config,
                           std::string &graph_filename, bool &ret) {
 
@@ -44,8 +59,27 @@ int parse_matching_parameters(int argn, char **argv,  MatchingConfig &matching_c
     struct arg_int *seed     = arg_int0(NULL, "seed", NULL, "set seed for RNG");
     struct arg_int *oseed     = arg_int0(NULL, "oseed", NULL, "set seed for RNG used for shuffling the order of algorithms");
 
-    struct arg_str *filename = arg_strn(NULL, NULL, "FILE", 1, 1, "Path to graph file to partition.");
+    struct arg_str *filename = arg_strn(NULL, NULL, "FILE", 1, 1, "Path to graph file to partition (text input may be compressed: .gz/.zst).");
     struct arg_str *outfile = arg_str0(NULL, "results-output", NULL, "Target file for result output");
+    struct arg_lit *binary_results = arg_lit0(NULL, "binary-results", "write the results in a binary columnar format (requires --results-output)");
+    struct arg_int *parse_threads = arg_int0(NULL, "parse-threads", NULL, "parse text input with this many threads");
+    struct arg_lit *stream = arg_lit0(NULL, "stream", "read the input one delta at a time (input must be sorted by timestamp)");
+    struct arg_str *vertex_order = arg_str0(NULL, "vertex-order", "{first,degree,rcm}", "renumber vertices densely at load time, in order of first appearance, by degree or in reverse Cuthill-McKee order");
+    struct arg_int *start_at = arg_int0(NULL, "start-at", "DELTA", "bulk-load the graph as of the delta before DELTA, then process deltas incrementally from DELTA on");
+    struct arg_str *start_at_time = arg_str0(NULL, "start-at-time", "TIMESTAMP", "like --start-at, starting with the first delta at or after TIMESTAMP");
+    struct arg_lit *coalesce = arg_lit0(NULL, "coalesce", "collapse the updates of an arc within a delta into a single one and drop updates without net change");
+    struct arg_str *window_span = arg_str0(NULL, "window-time", "SPAN", "group all updates within SPAN timestamp units into a single delta");
+    struct arg_int *window_updates = arg_int0(NULL, "window-updates", "N", "group every N consecutive updates into a single delta");
+    struct arg_dbl *half_life = arg_dbl0(NULL, "decay-half-life", "H", "treat weights as demands that decay exponentially with half-life H (in timestamp units)");
+    struct arg_lit *prefetch = arg_lit0(NULL, "prefetch", "read the next deltas on a background thread while the algorithms run");
+    struct arg_int *threads = arg_int0(NULL, "threads", "N", "run up to N (b, algorithm) combinations in parallel");
+    struct arg_lit *single_pass = arg_lit0(NULL, "single-pass", "apply each delta once and run all algorithms on it, instead of replaying the trace per algorithm");
+    struct arg_lit *shared_b = arg_lit0(NULL, "shared-b", "replay the trace once for all b, sharing the graph and the order of arcs by weight");
+    struct arg_dbl *time_budget = arg_dbl0(NULL, "time-budget", "SECONDS", "stop post-processing and recomputations from scratch after SECONDS per delta");
+    struct arg_lit *isolate = arg_lit0(NULL, "isolate", "perform each (b, algorithm) run in a forked child process");
+    struct arg_lit *bulk_init = arg_lit0(NULL, "bulk-init", "build the graph of the first delta before running the algorithms, which take it over at once");
+    struct arg_str *capture_events = arg_str0(NULL, "capture-events", "FILE", "record the weight changes seen by the algorithms per delta into FILE, for DyDjReplayEvents");
+    struct arg_str *diff_output = arg_str0(NULL, "diff-output", "FILE", "write the arcs whose color changed per delta into FILE (implies count_color_ops)");
     struct arg_end *end = arg_end(100);
 
     void *argtable[] = {
@@ -54,6 +88,25 @@ int parse_matching_parameters(int argn, char **argv,  MatchingConfig &matching_c
             seed,
             oseed,
             outfile,
+            binary_results,
+            parse_threads,
+            stream,
+            vertex_order,
+            start_at,
+            start_at_time,
+            coalesce,
+            window_span,
+            window_updates,
+            half_life,
+            prefetch,
+            threads,
+            single_pass,
+            shared_b,
+            time_budget,
+            isolate,
+            bulk_init,
+            capture_events,
+            diff_output,
             end
     };
 
@@ -89,6 +142,170 @@ int parse_matching_parameters(int argn, char **argv,  MatchingConfig &matching_c
         matching_config.writeOutputfile = true;
     }
 
+    if (binary_results->count > 0) {
+        if (outfile->count == 0) {
+            std::cerr << "--binary-results requires --results-output" << std::endl;
+            arg_freetable(argtable, sizeof(argtable) / sizeof(argtable[0]));
+            return 1;
+        }
+        matching_config.binary_results = true;
+    }
+
+    if (parse_threads->count > 0) {
+        if (parse_threads->ival[0] < 1) {
+            std::cerr << "Number of parse threads must be positive" << std::endl;
+            arg_freetable(argtable, sizeof(argtable) / sizeof(argtable[0]));
+            return 1;
+        }
+        matching_config.parse_threads = parse_threads->ival[0];
+    }
+
+    if (stream->count > 0) {
+        matching_config.stream_input = true;
+    }
+
+    if (vertex_order->count > 0) {
+        std::string order = vertex_order->sval[0];
+        for (auto candidate : {VertexOrder::FIRST_APPEARANCE, VertexOrder::DEGREE, VertexOrder::RCM}) {
+            if (order == vertex_order_names[static_cast<int>(candidate)]) {
+                matching_config.vertex_order = candidate;
+            }
+        }
+        if (matching_config.vertex_order == VertexOrder::NONE) {
+            std::cerr << "Unknown vertex order " << order << std::endl;
+            arg_freetable(argtable, sizeof(argtable) / sizeof(argtable[0]));
+            return 1;
+        }
+        if (matching_config.stream_input) {
+            std::cerr << "Vertex reordering needs the whole trace in memory and cannot be combined with --stream" << std::endl;
+            arg_freetable(argtable, sizeof(argtable) / sizeof(argtable[0]));
+            return 1;
+        }
+    }
+
+    if (start_at->count > 0) {
+        if (start_at->ival[0] < 1) {
+            std::cerr << "Start delta must be positive" << std::endl;
+            arg_freetable(argtable, sizeof(argtable) / sizeof(argtable[0]));
+            return 1;
+        }
+        matching_config.start_delta = start_at->ival[0];
+    }
+    if (start_at_time->count > 0) {
+        std::istringstream timestamp(start_at_time->sval[0]);
+        unsigned long long value;
+        if (!(timestamp >> value) || start_at->count > 0) {
+            std::cerr << "--start-at-time expects a timestamp and cannot be combined with --start-at" << std::endl;
+            arg_freetable(argtable, sizeof(argtable) / sizeof(argtable[0]));
+            return 1;
+        }
+        matching_config.start_timestamp = value;
+    }
+
+    if (coalesce->count > 0) {
+        matching_config.coalesce_updates = true;
+    }
+
+    if (window_span->count > 0) {
+        std::istringstream span(window_span->sval[0]);
+        unsigned long long value;
+        if (!(span >> value) || value == 0 || window_updates->count > 0) {
+            std::cerr << "--window-time expects a positive span and cannot be combined with --window-updates" << std::endl;
+            arg_freetable(argtable, sizeof(argtable) / sizeof(argtable[0]));
+            return 1;
+        }
+        matching_config.window_span = value;
+    }
+    if (window_updates->count > 0) {
+        if (window_updates->ival[0] < 1) {
+            std::cerr << "Number of updates per window must be positive" << std::endl;
+            arg_freetable(argtable, sizeof(argtable) / sizeof(argtable[0]));
+            return 1;
+        }
+        matching_config.window_updates = window_updates->ival[0];
+    }
+
+    if (half_life->count > 0) {
+        if (!(half_life->dval[0] > 0) || start_at->count > 0 || start_at_time->count > 0) {
+            std::cerr << "--decay-half-life expects a positive half-life and cannot be combined with --start-at(-time)" << std::endl;
+            arg_freetable(argtable, sizeof(argtable) / sizeof(argtable[0]));
+            return 1;
+        }
+        matching_config.decay_half_life = half_life->dval[0];
+    }
+
+    if (prefetch->count > 0) {
+        matching_config.prefetch_deltas = true;
+    }
+
+    if (threads->count > 0) {
+        if (threads->ival[0] < 1) {
+            std::cerr << "Number of threads must be positive" << std::endl;
+            arg_freetable(argtable, sizeof(argtable) / sizeof(argtable[0]));
+            return 1;
+        }
+        matching_config.threads = threads->ival[0];
+    }
+
+    if (single_pass->count > 0) {
+        if (matching_config.threads > 1) {
+            std::cerr << "--single-pass cannot be combined with --threads" << std::endl;
+            arg_freetable(argtable, sizeof(argtable) / sizeof(argtable[0]));
+            return 1;
+        }
+        matching_config.single_pass = true;
+    }
+
+    if (shared_b->count > 0) {
+        if (matching_config.threads > 1) {
+            std::cerr << "--shared-b cannot be combined with --threads" << std::endl;
+            arg_freetable(argtable, sizeof(argtable) / sizeof(argtable[0]));
+            return 1;
+        }
+        matching_config.shared_b = true;
+    }
+
+    if (time_budget->count > 0) {
+        if (!(time_budget->dval[0] > 0)) {
+            std::cerr << "Time budget must be positive" << std::endl;
+            arg_freetable(argtable, sizeof(argtable) / sizeof(argtable[0]));
+            return 1;
+        }
+        matching_config.delta_time_budget = time_budget->dval[0];
+    }
+
+    if (isolate->count > 0) {
+        if (matching_config.threads > 1) {
+            std::cerr << "--isolate cannot be combined with --threads" << std::endl;
+            arg_freetable(argtable, sizeof(argtable) / sizeof(argtable[0]));
+            return 1;
+        }
+        matching_config.isolate_runs = true;
+    }
+
+    if (bulk_init->count > 0) {
+        if (half_life->count > 0) {
+            std::cerr << "--bulk-init cannot be combined with --decay-half-life" << std::endl;
+            arg_freetable(argtable, sizeof(argtable) / sizeof(argtable[0]));
+            return 1;
+        }
+        matching_config.bulk_init = true;
+    }
+
+    if (capture_events->count > 0) {
+        matching_config.capture_events_file = capture_events->sval[0];
+    }
+
+    if (diff_output->count > 0) {
+        if (isolate->count > 0) {
+            std::cerr << "--diff-output cannot be combined with --isolate" << std::endl;
+            arg_freetable(argtable, sizeof(argtable) / sizeof(argtable[0]));
+            return 1;
+        }
+        matching_config.diff_output_file = diff_output->sval[0];
+        matching_config.count_coloring_ops = true;
+    }
+
     arg_freetable(argtable, sizeof(argtable) / sizeof(argtable[0]));
 
     return 0;
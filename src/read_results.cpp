@@ -0,0 +1,178 @@
+/**
+ * Copyright (C) 2022-2023 : Kathrin Hanauer, Lara Ost
+ *
+ * This file is part of DyDJ Match.
+ *
+ * DyDJ Match is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DyDJ Match is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DyDJ Match.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact information:
+ *   https://github.com/DJ-Match/DyDJ-Match
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "extern/argtable3-3.0.3/argtable3.h"
+
+#include "io/binary_results.h"
+#include "io/coloring_diff.h"
+
+// Print the coloring changes written by `DyDjMatch --diff-output` as CSV, one row per changed arc.
+// Uncolored is printed as -1.
+bool print_coloring_diffs(const std::string &filename) {
+    std::ostringstream block;
+    block << "b,Delta,Algorithm,tail,head,old color,new color\n";
+    auto print_color = [&block](color_t color) {
+        if (color == UNCOLORED) {
+            block << -1;
+        } else {
+            block << color;
+        }
+    };
+    bool success = read_coloring_diffs(filename, [&](const ColoringDiffRun &run, std::uint64_t delta,
+                                                     const std::vector<ColoringDiffRecord> &records) {
+        for (const auto &record : records) {
+            block << run.b << ',' << delta << ',' << run.algorithm << ',' << record.tail << ',' << record.head << ',';
+            print_color(record.old_color);
+            block << ',';
+            print_color(record.new_color);
+            block << '\n';
+        }
+        if (block.tellp() >= (1 << 16)) {
+            std::cout << block.str();
+            block.str(std::string());
+        }
+    });
+    std::cout << block.str();
+    std::cout.flush();
+    return success;
+}
+
+// Prints a results file written by `DyDjMatch --binary-results` as CSV, formatted like the text output.
+// The file is memory-mapped and read row group by row group.
+// Coloring changes written by `DyDjMatch --diff-output` are printed as well.
+int main(int argc, char **argv) {
+    const char *progname = argv[0];
+
+    struct arg_lit *help = arg_lit0(NULL, "help", "Print help.");
+    struct arg_str *input = arg_strn(NULL, NULL, "RESULTS", 1, 1, "Path to the binary results file or coloring changes.");
+    struct arg_str *columns = arg_str0(NULL, "columns", "NAMES", "comma-separated names of the columns to print (default: all)");
+    struct arg_end *end = arg_end(100);
+
+    void *argtable[] = {
+            help,
+            input,
+            columns,
+            end
+    };
+
+    int nerrors = arg_parse(argc, argv, argtable);
+
+    if (help->count > 0) {
+        printf("Usage: %s", progname);
+        arg_print_syntax(stdout, argtable, "\n");
+        arg_print_glossary(stdout, argtable,"  %-40s %s\n");
+        arg_freetable(argtable, sizeof(argtable) / sizeof(argtable[0]));
+        return 0;
+    }
+
+    if (nerrors > 0) {
+        arg_print_errors(stderr, end, progname);
+        printf("Try '%s --help' for more information.\n",progname);
+        arg_freetable(argtable, sizeof(argtable) / sizeof(argtable[0]));
+        return 1;
+    }
+
+    std::string input_filename = input->sval[0];
+    std::string column_names = columns->count > 0 ? columns->sval[0] : "";
+    arg_freetable(argtable, sizeof(argtable) / sizeof(argtable[0]));
+
+    if (is_coloring_diff(input_filename)) {
+        if (!column_names.empty()) {
+            std::cerr << "--columns is not supported for coloring changes" << std::endl;
+            return 1;
+        }
+        return print_coloring_diffs(input_filename) ? 0 : 1;
+    }
+
+    BinaryResultsReader reader;
+    if (!reader.open(input_filename)) {
+        return 1;
+    }
+
+    // Indices of the columns to print
+    std::vector<std::size_t> selected;
+    if (column_names.empty()) {
+        for (std::size_t i = 0; i < reader.get_columns().size(); i++) {
+            selected.push_back(i);
+        }
+    } else {
+        std::istringstream names(column_names);
+        std::string name;
+        while (std::getline(names, name, ',')) {
+            auto index = reader.column_index(name);
+            if (index == reader.get_columns().size()) {
+                std::cerr << "Unknown column " << name << std::endl;
+                return 1;
+            }
+            selected.push_back(index);
+        }
+    }
+
+    std::ostringstream block;
+    block << std::fixed << std::setprecision(6);
+    for (std::size_t i = 0; i < selected.size(); i++) {
+        block << (i > 0 ? "," : "") << reader.get_columns()[selected[i]].name;
+    }
+    block << '\n';
+    for (const auto &group : reader.get_row_groups()) {
+        for (std::size_t row = 0; row < group.num_rows; row++) {
+            for (std::size_t i = 0; i < selected.size(); i++) {
+                const auto column = selected[i];
+                if (i > 0) {
+                    block << ',';
+                }
+                switch (reader.get_columns()[column].type) {
+                    case BinaryColumnType::INT32:
+                        block << group.values<std::int32_t>(column)[row];
+                        break;
+                    case BinaryColumnType::INT64:
+                        block << group.values<std::int64_t>(column)[row];
+                        break;
+                    case BinaryColumnType::UINT32:
+                        block << group.values<std::uint32_t>(column)[row];
+                        break;
+                    case BinaryColumnType::UINT64:
+                        block << group.values<std::uint64_t>(column)[row];
+                        break;
+                    case BinaryColumnType::FLOAT64:
+                        block << group.values<double>(column)[row];
+                        break;
+                    case BinaryColumnType::STRING:
+                        block << group.string(column, row);
+                        break;
+                }
+            }
+            block << '\n';
+        }
+        std::cout << block.str();
+        block.str(std::string());
+    }
+    std::cout.flush();
+
+    return 0;
+}
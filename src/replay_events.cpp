@@ -0,0 +1,203 @@
+/**
+ * Copyright (C) 2022-2023 : Kathrin Hanauer, Lara Ost
+ *
+ * This file is part of DyDJ Match.
+ *
+ * DyDJ Match is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DyDJ Match is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DyDJ Match.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact information:
+ *   https://github.com/DJ-Match/DyDJ-Match
+ */
+
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "extern/argtable3-3.0.3/argtable3.h"
+
+#include "graph.incidencelist/incidencelistgraph.h"
+#include "property/modifiableproperty.h"
+
+#include "io/event_log.h"
+#include "parse_configuration.h"
+#include "tools/callback_timer.h"
+#include "tools/chronotimer.h"
+#include "tools/result_table.h"
+
+// Replays an event log recorded with `DyDjMatch --capture-events` into the configured algorithms.
+// The log is decoded completely before replaying it; per delta, only the recorded weight changes are
+// performed, inserting an arc when its weight becomes positive and removing it when its weight drops
+// to 0. The measurements thus contain no I/O, parsing or bookkeeping of a dynamic graph: the time of each
+// delta covers only the callbacks of the algorithm, not the graph updates that trigger them, and `run`.
+int main(int argc, char **argv) {
+    const char *progname = argv[0];
+
+    struct arg_lit *help = arg_lit0(NULL, "help", "Print help.");
+    struct arg_str *input = arg_strn(NULL, NULL, "EVENTS", 1, 1, "Path to the event log to replay.");
+    struct arg_str *outfile = arg_str0(NULL, "results-output", NULL, "Target file for result output");
+    struct arg_lit *binary_results = arg_lit0(NULL, "binary-results", "write the results in a binary columnar format (requires --results-output)");
+    struct arg_end *end = arg_end(100);
+
+    void *argtable[] = {
+            help,
+            input,
+            outfile,
+            binary_results,
+            end
+    };
+
+    int nerrors = arg_parse(argc, argv, argtable);
+
+    if (help->count > 0) {
+        printf("Usage: %s", progname);
+        arg_print_syntax(stdout, argtable, " [< configfile]\n");
+        arg_print_glossary(stdout, argtable,"  %-40s %s\n");
+        arg_freetable(argtable, sizeof(argtable) / sizeof(argtable[0]));
+        return 0;
+    }
+
+    if (nerrors > 0) {
+        arg_print_errors(stderr, end, progname);
+        printf("Try '%s --help' for more information.\n",progname);
+        arg_freetable(argtable, sizeof(argtable) / sizeof(argtable[0]));
+        return 1;
+    }
+
+    auto config = std::make_shared<MatchingConfig>();
+    std::string events_filename = input->sval[0];
+    config->graph_filename = events_filename;
+    if (outfile->count > 0) {
+        config->outputFile = outfile->sval[0];
+        config->writeOutputfile = true;
+    }
+    if (binary_results->count > 0) {
+        if (outfile->count == 0) {
+            std::cerr << "--binary-results requires --results-output" << std::endl;
+            arg_freetable(argtable, sizeof(argtable) / sizeof(argtable[0]));
+            return 1;
+        }
+        config->binary_results = true;
+    }
+    arg_freetable(argtable, sizeof(argtable) / sizeof(argtable[0]));
+
+    // Read the configuration from standard input
+    std::vector<std::unique_ptr<AlgorithmBase>> algos;
+    if (!ConfigReader(*config, std::cin, algos).readConfig()) {
+        std::cerr << "Error reading configuration from stdin" << std::endl;
+        return 1;
+    }
+    for (auto &algo: algos) {
+        algo->configure(config);
+    }
+    if (config->all_bs.empty()) {
+        config->all_bs.push_back(1);
+    }
+
+    std::streambuf *buffer;
+    std::ofstream output_file_stream;
+    if (config->writeOutputfile) {
+        output_file_stream.open(config->outputFile, config->binary_results ? std::ios::out | std::ios::binary
+                                                                           : std::ios::out);
+        if (!output_file_stream.is_open()) {
+            std::cerr << "Failed to open output file " << config->outputFile << std::endl;
+            return 1;
+        }
+        buffer = output_file_stream.rdbuf();
+    } else {
+        buffer = std::cout.rdbuf();
+    }
+    std::ostream output_stream(buffer);
+
+    ChronoTimer timer;
+    EventLog events;
+    if (!events.read(events_filename)) {
+        std::cout << "Error! Could not read event log " << events_filename << "\n";
+        return 1;
+    }
+    std::cout << "Input I/O took " << timer.elapsed() << "s\n";
+    std::cout << "%n,m " << events.get_num_vertices() << "," << events.get_arcs().size() << "\n";
+
+    const auto &arc_endpoints = events.get_arcs();
+
+    ResultTable table(result_columns, output_stream,
+                      config->binary_results ? TableFormat::BINARY : TableFormat::CSV);
+    table.printHeader();
+
+    // Replay the whole log into `algo` with `b` matchings, see `run_delta` for `repetitions`
+    auto replay = [&](AlgorithmBase *algo, int b, RepeatedRuns *repetitions) {
+        // As in `DyDjMatch`, vertices are created along with their first arc
+        IncidenceListGraph graph;
+        std::vector<Vertex*> vertices(events.get_num_vertices(), nullptr);
+        auto vertex = [&graph, &vertices](std::uint64_t index) {
+            if (vertices[index] == nullptr) {
+                vertices[index] = graph.addVertex();
+            }
+            return vertices[index];
+        };
+        // Arc of each arc index, if present
+        std::vector<Arc*> arcs(arc_endpoints.size(), nullptr);
+        ModifiableProperty<EdgeWeight> weights(0);
+        // Time only the observers of the algorithm, which are registered between the markers
+        CallbackTimer<EdgeWeight> callbackTimer(&graph, &weights, 1);
+        callbackTimer.add_marker(0);
+        algo->setGraph(&graph);
+        algo->setWeights(&weights);
+        callbackTimer.add_marker(1);
+        algo->set_num_matchings(b);
+        algo->init();
+        for (std::size_t delta = 0; delta < events.num_deltas(); delta++) {
+            for (auto event = events.delta_begin(delta); event != events.delta_end(delta); ++event) {
+                auto &arc = arcs[event->arc];
+                if (arc == nullptr) {
+                    arc = graph.addArc(vertex(arc_endpoints[event->arc].first),
+                                       vertex(arc_endpoints[event->arc].second));
+                }
+                weights.setValue(arc, event->new_weight);
+                if (event->new_weight == 0) {
+                    graph.removeArc(arc);
+                    arc = nullptr;
+                }
+            }
+            auto deltaTime = callbackTimer.take(0); // Measure time of the algorithm's callbacks
+            run_delta(algo, b, delta + 1, deltaTime, &graph,
+                      events.delta_end(delta) - events.delta_begin(delta), nullptr, table, repetitions);
+        }
+        algo->unsetGraph();
+        algo->unsetWeights();
+    };
+
+    bool consistent = true;
+    for (auto b: config->all_bs) {
+        config->b = b;
+        for (auto &algo: algos) {
+            if (config->repeat == 1 && config->warmup == 0) {
+                replay(algo.get(), b, nullptr);
+                continue;
+            }
+            RepeatedRuns repetitions(config->warmup, config->repeat, config->delta_time_budget <= 0);
+            while (repetitions.next_replay()) {
+                replay(algo.get(), b, &repetitions);
+            }
+            consistent = write_repeated_runs(repetitions, table) && consistent;
+        }
+    }
+
+    table.flush();
+    output_stream.rdbuf(nullptr);
+
+    return consistent ? 0 : 1;
+}
@@ -0,0 +1,96 @@
+/**
+ * Copyright (C) 2022-2023 : Kathrin Hanauer, Lara Ost
+ *
+ * This file is part of DyDJ Match.
+ *
+ * DyDJ Match is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DyDJ Match is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DyDJ Match.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact information:
+ *   https://github.com/DJ-Match/DyDJ-Match
+ */
+
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+#include "graph/arc.h"
+#include "graph/digraph.h"
+#include "property/modifiableproperty.h"
+
+using namespace Algora;
+
+// Attributes the time spent in the graph observers of several algorithms to the individual algorithms,
+// when all of them observe the same graph and weights.
+// A marker is registered before the observers of each algorithm and after those of the last one.
+// Observers are notified in the order of their registration, so the time between two consecutive
+// markers is spent by the algorithm whose observers are registered between them.
+template<typename T>
+class CallbackTimer {
+
+public:
+    CallbackTimer(DiGraph *graph, ModifiableProperty<T> *weights, std::size_t num_algorithms)
+        : graph(graph), weights(weights), markers(num_algorithms + 1), seconds(num_algorithms, 0) {}
+
+    CallbackTimer(const CallbackTimer&) = delete;
+    CallbackTimer& operator=(const CallbackTimer&) = delete;
+
+    ~CallbackTimer() {
+        for (auto &marker : markers) {
+            graph->removeOnArcAdd(&marker);
+            graph->removeOnArcRemove(&marker);
+            weights->removeOnPropertyChange(&marker);
+        }
+    }
+
+    // Register the marker preceding the observers of algorithm `index`,
+    // or the final marker if `index` is the number of algorithms.
+    void add_marker(std::size_t index) {
+        graph->onArcAdd(&markers[index], [this, index](Arc*) { record(ARC_ADD, index); });
+        graph->onArcRemove(&markers[index], [this, index](Arc*) { record(ARC_REMOVE, index); });
+        weights->onPropertyChange(&markers[index], [this, index](GraphArtifact*, const T&, const T&) {
+            record(PROPERTY_CHANGE, index);
+        });
+    }
+
+    // Time spent in the observers of algorithm `index` since the last call.
+    double take(std::size_t index) {
+        double result = seconds[index];
+        seconds[index] = 0;
+        return result;
+    }
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    enum Event { ARC_ADD, ARC_REMOVE, PROPERTY_CHANGE, NUM_EVENTS };
+
+    void record(Event event, std::size_t index) {
+        const auto now = clock::now();
+        if (index > 0) {
+            seconds[index - 1] += std::chrono::duration<double>(now - last[event]).count();
+        }
+        last[event] = now;
+    }
+
+    DiGraph *graph;
+    ModifiableProperty<T> *weights;
+    // Only the addresses of the markers are used, as observer ids
+    std::vector<char> markers;
+    std::vector<double> seconds;
+    std::array<clock::time_point, NUM_EVENTS> last;
+};
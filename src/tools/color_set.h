@@ -22,11 +22,28 @@
 
 #pragma once
 
+#include <cassert>
+#include <cstdint>
+#include <ostream>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+    #include <immintrin.h>
+#endif
+
 #include "algorithm/matching_defs.h"
 
-struct color_set {
+// Maximum number of colors, i.e., of b. Up to 64 colors fit into a single word;
+// larger values select a multi-word `color_set` (see `MAX_COLORS` in CMakeLists.txt).
+#ifndef DYDJ_MAX_COLORS
+    #define DYDJ_MAX_COLORS 64
+#endif
+
+// Set of up to 64 colors in a single word
+struct single_word_color_set {
     using size_type = unsigned int;
     static constexpr size_type npos = -1;
+    static constexpr size_type max_colors = 64;
 
 private:
     using bit_type = unsigned long;
@@ -36,18 +53,20 @@ private:
     bit_type all_bits;
     size_type bit_size;
 
-    inline color_set(bit_type bits, bit_type all, size_type size) : bits(bits),
-                                                                    all_bits(all),
-                                                                    bit_size(size) {}
+    inline single_word_color_set(bit_type bits, bit_type all, size_type size) : bits(bits),
+                                                                                all_bits(all),
+                                                                                bit_size(size) {}
 
-    friend color_set operator&(const color_set &a, const color_set &b);
+    friend single_word_color_set operator&(const single_word_color_set &a, const single_word_color_set &b);
 
 public:
-    color_set() : bits(0), all_bits(0), bit_size(0) {}
+    single_word_color_set() : bits(0), all_bits(0), bit_size(0) {}
 
     // Create a new `color_set`. By default, all colors are included.
-    color_set(size_type size) : all_bits((one << size) - 1), // 2^bit_size - 1 -> bit_size many bits are set to 1
-                                bit_size(size) {
+    // Shifting by the width of the word is undefined, so 64 colors set all bits directly.
+    single_word_color_set(size_type size) : all_bits(size >= max_colors ? ~bit_type{0} : (one << size) - 1),
+                                            bit_size(size) {
+        assert(size <= max_colors);
         bits = all_bits;
     }
 
@@ -60,6 +79,9 @@ public:
     }
 
     inline size_type find_next(size_type pos) const {
+        if (pos >= max_colors) {
+            return npos;
+        }
         auto shifted = bits >> pos;
         if (shifted == 0) {
             return npos;
@@ -98,27 +120,28 @@ public:
     }
 
     inline size_type count() const {
-        size_type count = 0;
-        for (size_type i = 0; i < bit_size; ++i) {
-            count += ((bits & (one << i)) != 0);
-        }
-        return count;
+        return __builtin_popcountl(bits);
     }
 
     inline size_type size() const {
         return bit_size;
     }
 
-    static inline color_set common_colors(const color_set &a, const color_set &b) {
+    static inline single_word_color_set common_colors(const single_word_color_set &a, const single_word_color_set &b) {
         return (a & b);
     }
 
+    // Smallest color in both `a` and `b`, or `npos`, without materializing their intersection
+    static inline size_type first_common(const single_word_color_set &a, const single_word_color_set &b) {
+        assert(a.size() == b.size());
+        auto common = a.bits & b.bits;
+        return common == 0 ? npos : lowestBit(common);
+    }
+
     inline bool operator[](size_type i) const {
         return bits & (one << i);
     }
 
-    friend std::ostream& operator<<(std::ostream &stream, const color_set &c);
-
 private:
 
     static size_type lowestBit(bit_type b) {
@@ -127,13 +150,200 @@ private:
 
 };
 
-inline color_set operator&(const color_set &a, const color_set &b) {
+inline single_word_color_set operator&(const single_word_color_set &a, const single_word_color_set &b) {
     assert(a.size() == b.size());
     return {a.bits & b.bits, a.all_bits, a.bit_size};
 }
 
+// Set of up to `64 * num_words` colors.
+// Scans and intersections process four words at a time with AVX2 or two with SSE2, if available.
+template<unsigned num_words>
+struct wide_color_set {
+    using size_type = unsigned int;
+    static constexpr size_type npos = -1;
+    static constexpr size_type max_colors = 64 * num_words;
+
+private:
+    using word_type = std::uint64_t;
+    static constexpr size_type word_bits = 64;
+    static constexpr word_type one = 1u;
+
+    alignas(32) word_type words[num_words];
+    size_type bit_size;
+
+    // Whether the blocks of four or two words starting at `a` and `b` have a common bit
+#ifdef __AVX2__
+    static inline bool intersect4(const word_type *a, const word_type *b) {
+        auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+        auto y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+        return !_mm256_testz_si256(x, y);
+    }
+#endif
+#ifdef __SSE2__
+    static inline bool intersect2(const word_type *a, const word_type *b) {
+        auto x = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a)),
+                               _mm_loadu_si128(reinterpret_cast<const __m128i*>(b)));
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_setzero_si128())) != 0xffff;
+    }
+#endif
+
+    // Index of the first word in `[from, num_words)` in which `a` and `b` have a common bit, or `num_words`
+    static inline unsigned first_common_word(const word_type *a, const word_type *b, unsigned from) {
+        unsigned i = from;
+#ifdef __AVX2__
+        for (; i + 4 <= num_words && !intersect4(a + i, b + i); i += 4) {}
+#endif
+#ifdef __SSE2__
+        for (; i + 2 <= num_words && !intersect2(a + i, b + i); i += 2) {}
+#endif
+        for (; i < num_words; i++) {
+            if ((a[i] & b[i]) != 0) {
+                return i;
+            }
+        }
+        return num_words;
+    }
+
+    // Index of the first non-zero word in `[from, num_words)`, or `num_words`
+    inline unsigned first_nonzero_word(unsigned from) const {
+        return first_common_word(words, words, from);
+    }
+
+    static size_type lowestBit(word_type w) {
+        return __builtin_ctzll(w);
+    }
+
+public:
+    wide_color_set() : words{}, bit_size(0) {}
+
+    // Create a new `color_set`. By default, all colors are included.
+    wide_color_set(size_type size) : bit_size(size) {
+        assert(size <= max_colors);
+        set();
+    }
+
+    inline size_type find_first() const {
+        auto i = first_nonzero_word(0);
+        return i == num_words ? npos : i * word_bits + lowestBit(words[i]);
+    }
+
+    inline size_type find_next(size_type pos) const {
+        if (pos >= max_colors) {
+            return npos;
+        }
+        const unsigned i = pos / word_bits;
+        auto shifted = words[i] >> (pos % word_bits);
+        if (shifted != 0) {
+            return pos + lowestBit(shifted);
+        }
+        auto j = first_nonzero_word(i + 1);
+        return j == num_words ? npos : j * word_bits + lowestBit(words[j]);
+    }
+
+    inline void flip() {
+        // Flip all bits, then set unused bits to 0
+        for (unsigned i = 0; i < num_words; i++) {
+            words[i] = ~words[i];
+        }
+        clear_unused();
+    }
+
+    inline void set() {
+        for (unsigned i = 0; i < num_words; i++) {
+            words[i] = ~word_type{0};
+        }
+        clear_unused();
+    }
+
+    inline void setOn(size_type i) {
+        words[i / word_bits] |= one << (i % word_bits);
+    }
+
+    inline void setOff(size_type i) {
+        words[i / word_bits] ^= one << (i % word_bits);
+    }
+
+    inline bool none() const {
+        return first_nonzero_word(0) == num_words;
+    }
+
+    inline bool any() const {
+        return !none();
+    }
+
+    inline bool all() const {
+        return count() == bit_size;
+    }
+
+    inline size_type count() const {
+        size_type count = 0;
+        for (unsigned i = 0; i < num_words; i++) {
+            count += __builtin_popcountll(words[i]);
+        }
+        return count;
+    }
+
+    inline size_type size() const {
+        return bit_size;
+    }
+
+    static inline wide_color_set common_colors(const wide_color_set &a, const wide_color_set &b) {
+        assert(a.size() == b.size());
+        wide_color_set result;
+        result.bit_size = a.bit_size;
+        unsigned i = 0;
+#ifdef __AVX2__
+        for (; i + 4 <= num_words; i += 4) {
+            auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a.words + i));
+            auto y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b.words + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(result.words + i), _mm256_and_si256(x, y));
+        }
+#endif
+#ifdef __SSE2__
+        for (; i + 2 <= num_words; i += 2) {
+            auto x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a.words + i));
+            auto y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b.words + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(result.words + i), _mm_and_si128(x, y));
+        }
+#endif
+        for (; i < num_words; i++) {
+            result.words[i] = a.words[i] & b.words[i];
+        }
+        return result;
+    }
+
+    // Smallest color in both `a` and `b`, or `npos`, without materializing their intersection
+    static inline size_type first_common(const wide_color_set &a, const wide_color_set &b) {
+        assert(a.size() == b.size());
+        auto i = first_common_word(a.words, b.words, 0);
+        return i == num_words ? npos : i * word_bits + lowestBit(a.words[i] & b.words[i]);
+    }
+
+    inline bool operator[](size_type i) const {
+        return words[i / word_bits] & (one << (i % word_bits));
+    }
+
+private:
+    inline void clear_unused() {
+        const unsigned used_words = (bit_size + word_bits - 1) / word_bits;
+        for (unsigned i = used_words; i < num_words; i++) {
+            words[i] = 0;
+        }
+        if (used_words > 0) {
+            const auto used = bit_size - (used_words - 1) * word_bits;
+            if (used < word_bits) {
+                words[used_words - 1] &= (one << used) - 1;
+            }
+        }
+    }
+};
+
+using color_set = std::conditional_t<(DYDJ_MAX_COLORS <= 64),
+                                     single_word_color_set,
+                                     wide_color_set<(DYDJ_MAX_COLORS + 63) / 64>>;
+
 inline std::ostream& operator<<(std::ostream &stream, const color_set &c) {
-    for (color_set::size_type i = c.bit_size; i > 0; --i) {
+    for (color_set::size_type i = c.size(); i > 0; --i) {
         stream << (int)(c[i-1]);
     }
     return stream;
@@ -26,16 +26,29 @@
 #pragma once
 
 #include <array>
+#include <condition_variable>
 #include <iomanip>
 #include <iostream>
+#include <mutex>
+#include <sstream>
 #include <string>
+#include <thread>
+#include <tuple>
 #include <vector>
 #include <utility>
 
+#include "io/binary_results.h"
+
 // Generic formatting
 template<typename D>
 void format(std::ostream &/*stream*/) {}
 
+// Output formats of tables: comma-separated text, or the columnar format of `io/binary_results.h`
+enum class TableFormat {
+    CSV,
+    BINARY
+};
+
 template<int width, class T>
 struct TableEntry {
     using datatype = T;
@@ -44,96 +57,255 @@ struct TableEntry {
     }
 };
 
+// Writes rows to a stream on a background thread.
+// Rows are added by a single thread and handed to the writer through a ring buffer of fixed capacity,
+// so that the memory used is constant; the writer formats them and writes them to the stream in large
+// blocks. Adding a row only waits if the writer falls behind by `queue_capacity` rows.
+// Other output to the stream must go through `addText` or `addOutput` to keep its order with the rows,
+// or follow a call of `flush`.
+// In the binary format, rows are written in row groups of `row_group_size` rows (or fewer, on `flush`).
+// Output added by `addOutput` is then dropped, and text added by `addText` must consist of row groups
+// written by another binary table with the same columns.
 template<bool use_width, class... T>
 class DataTable {
 
 public:
     static constexpr size_t num_columns = sizeof...(T);
+    // Number of rows (or texts) that can be queued for the writer
+    static constexpr size_t queue_capacity = 1024;
+    // The writer is woken once this many rows are queued, or on `flush`
+    static constexpr size_t wake_threshold = queue_capacity / 4;
+    // Formatted rows are written to the stream in blocks of about this many bytes
+    static constexpr size_t block_size = 1 << 16;
+    // Maximum number of rows of a row group in the binary format
+    static constexpr size_t row_group_size = 8192;
 
     DataTable(const std::array<std::string, num_columns> &column_names,
-              std::ostream &stream) :
-        column_names(column_names), stream(stream) {}
+              std::ostream &stream, TableFormat table_format = TableFormat::CSV) :
+        column_names(column_names), stream(stream), table_format(table_format), queue(queue_capacity) {
+        writer = std::thread(&DataTable::write, this);
+    }
+
+    DataTable(const DataTable&) = delete;
+    DataTable& operator=(const DataTable&) = delete;
+
+    // Writes all remaining rows
+    ~DataTable() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopped = true;
+        }
+        queued.notify_one();
+        writer.join();
+    }
 
     void addRow(const typename T::datatype... data) {
-        table.emplace_back(data...);
+        std::unique_lock<std::mutex> lock(mutex);
+        auto &entry = reserve(lock);
+        entry.row = std::tuple<typename T::datatype...>(data...);
+        entry.is_row = true;
+        commit(lock);
+    }
+
+    // Add `text` after the rows added so far, e.g., rows formatted elsewhere
+    void addText(std::string text) {
+        std::unique_lock<std::mutex> lock(mutex);
+        auto &entry = reserve(lock);
+        entry.text = std::move(text);
+        entry.is_row = false;
+        commit(lock);
+    }
+
+    // Add the output of `output(stream)`, if any, after the rows added so far
+    template<typename F>
+    void addOutput(F output) {
+        if (table_format == TableFormat::BINARY) {
+            return;
+        }
+        output(text_buffer);
+        if (text_buffer.tellp() > 0) {
+            addText(text_buffer.str());
+            text_buffer.str(std::string());
+        }
     }
 
     void printHeader() {
-        printEachHeaderElement();
-        stream << std::endl;
+        std::ostringstream header;
+        if (table_format == TableFormat::BINARY) {
+            write_binary_results_header(header, std::vector<std::string>(column_names.begin(), column_names.end()),
+                                        {binary_column_type<typename T::datatype>()...});
+        } else {
+            printEachHeaderElement(header);
+            header << '\n';
+        }
+        addText(header.str());
     }
 
+    // Wait until everything added so far is written, and flush the stream
     void flush() {
-        for(; current_row < table.size(); ++current_row) {
-            printRow(current_row);
-        }
+        std::unique_lock<std::mutex> lock(mutex);
+        flush_requested = true;
+        queued.notify_one();
+        flushed.wait(lock, [this]() { return !flush_requested; });
     }
 
 private:
+    struct Entry {
+        std::tuple<typename T::datatype...> row;
+        std::string text;
+        bool is_row = false;
+    };
+
     std::tuple<T...> typeinfo;
-    std::vector<std::tuple<typename T::datatype...>> table;
     std::array<std::string, num_columns> column_names;
 
     // Output stream to which the table is written
     std::ostream &stream;
+    const TableFormat table_format;
+
+    // Ring buffer of queued entries: the entries `head` to `tail - 1` (modulo `queue_capacity`)
+    // are yet to be written, all others belong to the thread adding rows
+    std::vector<Entry> queue;
+    size_t head = 0;
+    size_t tail = 0;
+    bool flush_requested = false;
+    bool stopped = false;
+    std::mutex mutex;
+    std::condition_variable queued;
+    std::condition_variable not_full;
+    std::condition_variable flushed;
+    std::thread writer;
 
-    size_t current_row = 0;
+    // Output collected by `addOutput`
+    std::ostringstream text_buffer;
+
+    // Wait for a free entry
+    Entry& reserve(std::unique_lock<std::mutex> &lock) {
+        not_full.wait(lock, [this]() { return tail - head < queue_capacity; });
+        return queue[tail % queue_capacity];
+    }
+
+    // Queue the reserved entry
+    void commit(std::unique_lock<std::mutex> &lock) {
+        if (++tail - head == wake_threshold) {
+            lock.unlock();
+            queued.notify_one();
+        }
+    }
+
+    void write() {
+        std::ostringstream block;
+        BinaryRowGroupWriter row_group(num_columns);
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            queued.wait(lock, [this]() { return tail - head >= wake_threshold || flush_requested || stopped; });
+            const bool flushing = flush_requested || stopped;
+            const auto end = tail;
+            lock.unlock();
+            for (auto i = head; i < end; i++) {
+                auto &entry = queue[i % queue_capacity];
+                if (entry.is_row && table_format == TableFormat::BINARY) {
+                    addEachRowElement(row_group, entry.row);
+                    row_group.end_row();
+                    if (row_group.num_rows() == row_group_size) {
+                        row_group.write(block);
+                    }
+                } else if (entry.is_row) {
+                    printEachRowElement(block, entry.row);
+                    block << '\n';
+                } else {
+                    row_group.write(block);
+                    block << entry.text;
+                    std::string().swap(entry.text);
+                }
+                if (static_cast<size_t>(block.tellp()) >= block_size) {
+                    writeBlock(block);
+                }
+            }
+            if (flushing) {
+                row_group.write(block);
+                writeBlock(block);
+                stream.flush();
+            }
+            lock.lock();
+            head = end;
+            not_full.notify_one();
+            if (flushing && head == tail) {
+                if (stopped) {
+                    return;
+                }
+                flush_requested = false;
+                flushed.notify_all();
+            }
+        }
+    }
+
+    void writeBlock(std::ostringstream &block) {
+        if (block.tellp() > 0) {
+            const auto data = block.str();
+            stream.write(data.data(), data.size());
+            block.str(std::string());
+        }
+    }
 
     template<size_t I>
-    void formatWidth() {
+    void formatWidth(std::ostream &out) {
         if constexpr (use_width) {
-            stream << std::setw(std::get<I>(typeinfo).getWidth());
+            out << std::setw(std::get<I>(typeinfo).getWidth());
         }
     }
 
     template<size_t I = 0>
     typename std::enable_if<I == num_columns, void>::type
-    printEachHeaderElement() {}
+    printEachHeaderElement(std::ostream &/*out*/) {}
 
     template<size_t I = 0>
     typename std::enable_if<I < num_columns - 1, void>::type
-    printEachHeaderElement() {
-        formatWidth<I>();
-        stream << column_names[I]
-               << ',';  // Hardcoded separator
-        printEachHeaderElement<I+1>();
+    printEachHeaderElement(std::ostream &out) {
+        formatWidth<I>(out);
+        out << column_names[I]
+            << ',';  // Hardcoded separator
+        printEachHeaderElement<I+1>(out);
     }
 
     // Last column header
     template<size_t I = 0>
     typename std::enable_if<I == num_columns - 1, void>::type
-    printEachHeaderElement() {
-        formatWidth<I>();
-        stream << column_names[I];
-        printEachHeaderElement<I+1>();
+    printEachHeaderElement(std::ostream &out) {
+        formatWidth<I>(out);
+        out << column_names[I];
+        printEachHeaderElement<I+1>(out);
+    }
+
+    template<size_t I = 0>
+    void addEachRowElement(BinaryRowGroupWriter &row_group, const std::tuple<typename T::datatype...> &row) {
+        if constexpr (I < num_columns) {
+            row_group.add(I, std::get<I>(row));
+            addEachRowElement<I+1>(row_group, row);
+        }
     }
 
     template<size_t I = 0>
     typename std::enable_if<I == num_columns, void>::type
-    printEachRowElement(size_t /*row_index*/) {}
+    printEachRowElement(std::ostream &/*out*/, const std::tuple<typename T::datatype...> &/*row*/) {}
 
     template<size_t I = 0>
     typename std::enable_if<I < num_columns - 1, void>::type
-    printEachRowElement(size_t row_index) {
-        formatWidth<I>();
-        format<typename std::tuple_element<I, std::tuple<T...>>::type::datatype>(stream);
-        stream << std::get<I>(table[row_index])
-               << ',';  // Hardcoded separator
-        printEachRowElement<I+1>(row_index);
+    printEachRowElement(std::ostream &out, const std::tuple<typename T::datatype...> &row) {
+        formatWidth<I>(out);
+        format<typename std::tuple_element<I, std::tuple<T...>>::type::datatype>(out);
+        out << std::get<I>(row)
+            << ',';  // Hardcoded separator
+        printEachRowElement<I+1>(out, row);
     }
 
     template<size_t I = 0>
     typename std::enable_if<I == num_columns - 1, void>::type
-    printEachRowElement(size_t row_index) {
-        formatWidth<I>();
-        format<typename std::tuple_element<I, std::tuple<T...>>::type::datatype>(stream);
-        stream << std::get<I>(table[row_index]);
-        printEachRowElement<I+1>(row_index);
-    }
-
-    void printRow(size_t row_index) {
-        printEachRowElement(row_index);
-        stream << std::endl;
+    printEachRowElement(std::ostream &out, const std::tuple<typename T::datatype...> &row) {
+        formatWidth<I>(out);
+        format<typename std::tuple_element<I, std::tuple<T...>>::type::datatype>(out);
+        out << std::get<I>(row);
+        printEachRowElement<I+1>(out, row);
     }
 
 };
@@ -0,0 +1,72 @@
+/**
+ * Copyright (C) 2022-2023 : Kathrin Hanauer, Lara Ost
+ *
+ * This file is part of DyDJ Match.
+ *
+ * DyDJ Match is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DyDJ Match is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DyDJ Match.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact information:
+ *   https://github.com/DJ-Match/DyDJ-Match
+ */
+
+
+#pragma once
+
+#include <chrono>
+
+// Cooperative deadline for computations that can stop early with a valid, if worse, result.
+// Long-running loops poll `expired()`; as reading the clock is comparatively expensive, it is
+// only read every `check_interval` polls.
+class Deadline {
+
+public:
+    static constexpr unsigned check_interval = 32;
+
+    // Set the deadline to `seconds` from now. A non-positive value disables the deadline.
+    void start(double seconds) {
+        enabled = seconds > 0;
+        passed = false;
+        countdown = 0;
+        if (enabled) {
+            end = std::chrono::steady_clock::now()
+                    + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                            std::chrono::duration<double>(seconds));
+        }
+    }
+
+    // Whether the deadline has passed. Once it has, this remains `true` until the next `start`.
+    bool expired() {
+        if (!enabled || passed) {
+            return passed;
+        }
+        if (countdown > 0) {
+            countdown--;
+            return false;
+        }
+        countdown = check_interval - 1;
+        passed = std::chrono::steady_clock::now() >= end;
+        return passed;
+    }
+
+    // Whether `expired()` has returned `true` since the last `start`.
+    bool missed() const {
+        return passed;
+    }
+
+private:
+    bool enabled = false;
+    bool passed = false;
+    unsigned countdown = 0;
+    std::chrono::steady_clock::time_point end;
+};
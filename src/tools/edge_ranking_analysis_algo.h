@@ -73,7 +73,8 @@ public:
                << "; heavy_weight: " << heavy_edge_weight
                << "; ranking: ";
         for (auto arc: edges) {
-            stream << "(" << arc->getTail()->getId() << "," << arc->getHead()->getId() << ") ";
+            stream << "(" << original_id(arc->getTail()) << ","
+                   << original_id(arc->getHead()) << ") ";
         }
         stream << std::endl;
     }
@@ -0,0 +1,78 @@
+/**
+ * Copyright (C) 2022-2023 : Kathrin Hanauer, Lara Ost
+ *
+ * This file is part of DyDJ Match.
+ *
+ * DyDJ Match is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DyDJ Match is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DyDJ Match.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact information:
+ *   https://github.com/DJ-Match/DyDJ-Match
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+
+#include "graph/arc.h"
+#include "graph/vertex.h"
+#include "property/modifiableproperty.h"
+
+#include "io/event_log.h"
+#include "io/trace_update.h"
+
+using namespace Algora;
+
+// Records the weight changes of a graph into an `EventLog`, in the order in which they are delivered
+// to observers. Arcs and vertices are numbered in the order of their first appearance, such that an
+// arc that is removed and inserted again keeps its number.
+template<typename T>
+class EventRecorder {
+
+public:
+    EventRecorder(ModifiableProperty<T> *weights, EventLog &log) : weights(weights), log(log) {
+        weights->onPropertyChange(this, [this](GraphArtifact *artifact, const T &oldValue, const T &newValue) {
+            auto arc = static_cast<Arc*>(artifact);
+            this->log.add_event(arc_index(arc), oldValue, newValue);
+        });
+    }
+
+    EventRecorder(const EventRecorder&) = delete;
+    EventRecorder& operator=(const EventRecorder&) = delete;
+
+    ~EventRecorder() {
+        weights->removeOnPropertyChange(this);
+    }
+
+private:
+    std::uint64_t vertex_index(const Vertex *vertex) {
+        return vertices.try_emplace(vertex, vertices.size()).first->second;
+    }
+
+    std::uint64_t arc_index(const Arc *arc) {
+        auto tail = vertex_index(arc->getTail());
+        auto head = vertex_index(arc->getHead());
+        auto [it, inserted] = arcs.try_emplace(std::make_pair(tail, head), 0);
+        if (inserted) {
+            it->second = log.add_arc(tail, head);
+        }
+        return it->second;
+    }
+
+    ModifiableProperty<T> *weights;
+    EventLog &log;
+    std::unordered_map<const Vertex*, std::uint64_t> vertices;
+    std::unordered_map<TraceArcKey, std::uint64_t, TraceArcKeyHash> arcs;
+};
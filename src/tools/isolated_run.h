@@ -0,0 +1,123 @@
+/**
+ * Copyright (C) 2022-2023 : Kathrin Hanauer, Lara Ost
+ *
+ * This file is part of DyDJ Match.
+ *
+ * DyDJ Match is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DyDJ Match is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DyDJ Match.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact information:
+ *   https://github.com/DJ-Match/DyDJ-Match
+ */
+
+
+#pragma once
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Runs `run` in a child process forked from the current one. The child sees all data loaded so far
+// copy-on-write, while its allocations leave the heap of the current process untouched.
+// `run(stream)` writes its output to `stream` and returns a trivially copyable `Report`.
+// Both are sent back over a pipe, along with the peak resident set size of the child in kB, which
+// includes the inherited pages that the child touched.
+// Returns `false` if the child could not be started or did not deliver its results.
+template<typename Report, typename F>
+bool run_isolated(F run, Report &report, std::string &output, long &peak_rss_kb) {
+    static_assert(std::is_trivially_copyable_v<Report>, "Report must be trivially copyable");
+    struct Header {
+        long peak_rss_kb;
+        std::size_t output_size;
+    };
+
+    int fds[2];
+    if (pipe(fds) != 0) {
+        std::cerr << "Could not create pipe: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    // Buffered output would otherwise be written by both processes
+    std::cout.flush();
+    std::cerr.flush();
+    const pid_t pid = fork();
+    if (pid < 0) {
+        std::cerr << "Could not fork: " << std::strerror(errno) << std::endl;
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+
+    if (pid == 0) {
+        close(fds[0]);
+        std::ostringstream stream;
+        const Report child_report = run(stream);
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        const std::string child_output = stream.str();
+        const Header header{usage.ru_maxrss, child_output.size()};
+        std::string message(reinterpret_cast<const char*>(&header), sizeof(header));
+        message.append(reinterpret_cast<const char*>(&child_report), sizeof(child_report));
+        message += child_output;
+        bool written = true;
+        for (std::size_t offset = 0; written && offset < message.size();) {
+            auto count = write(fds[1], message.data() + offset, message.size() - offset);
+            if (count > 0) {
+                offset += count;
+            } else if (count < 0 && errno != EINTR) {
+                written = false;
+            }
+        }
+        close(fds[1]);
+        std::cout.flush();
+        // Skip destructors and exit handlers, which belong to the parent
+        _exit(written ? 0 : 1);
+    }
+
+    close(fds[1]);
+    std::string message;
+    char buffer[1 << 16];
+    for (;;) {
+        auto count = read(fds[0], buffer, sizeof(buffer));
+        if (count > 0) {
+            message.append(buffer, count);
+        } else if (count == 0 || errno != EINTR) {
+            break;
+        }
+    }
+    close(fds[0]);
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+
+    Header header;
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0 || message.size() < sizeof(header) + sizeof(report)) {
+        std::cerr << "Isolated run did not complete" << std::endl;
+        return false;
+    }
+    std::memcpy(&header, message.data(), sizeof(header));
+    if (message.size() != sizeof(header) + sizeof(report) + header.output_size) {
+        std::cerr << "Isolated run delivered incomplete results" << std::endl;
+        return false;
+    }
+    std::memcpy(&report, message.data() + sizeof(header), sizeof(report));
+    output = message.substr(sizeof(header) + sizeof(report));
+    peak_rss_kb = header.peak_rss_kb;
+    return true;
+}
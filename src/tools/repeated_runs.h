@@ -0,0 +1,179 @@
+/**
+ * Copyright (C) 2022-2023 : Kathrin Hanauer, Lara Ost
+ *
+ * This file is part of DyDJ Match.
+ *
+ * DyDJ Match is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DyDJ Match is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DyDJ Match.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact information:
+ *   https://github.com/DJ-Match/DyDJ-Match
+ */
+
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "algorithm/disjoint_matching_algorithm.h"
+
+// Results of running an algorithm on a single delta, as reported in one row of the results
+struct DeltaResult {
+    int b;
+    int delta;
+    std::string algorithm;
+    EdgeWeight weight;
+    double time;
+    double delta_time;
+    ColoringStatsExtension::color_op_counts fine_counts;
+    ColoringStatsExtension::color_op_counts coarse_counts;
+    long num_arcs;
+    unsigned long delta_size;
+    // Hash of the solution, only computed when runs are repeated
+    std::uint64_t fingerprint;
+    // Output of `custom_output`, only kept when runs are repeated
+    std::string custom_output;
+};
+
+// Statistics over the times measured for a delta in repeated runs
+struct TimeSummary {
+    double mean_time;
+    double mean_delta_time;
+    double min;
+    double median;
+    double p95;
+    // Half-width of the 95% confidence interval of the mean time
+    double ci95;
+};
+
+// Collects the results of replaying the trace `warmup + repeat` times for the same algorithms and b.
+// The rows of the first replay are kept; the times of the last `repeat` replays are summarized per row.
+// Every replay is expected to compute the same solutions, i.e., the same weights and fingerprints,
+// unless `check_solutions` is `false`, e.g., because the work per delta is limited by a time budget.
+class RepeatedRuns {
+
+public:
+    RepeatedRuns(unsigned warmup, unsigned repeat, bool check_solutions = true)
+        : warmup(warmup), repeat(repeat), check_solutions(check_solutions) {}
+
+    // Start the next replay. Returns `false` once all replays are done.
+    bool next_replay() {
+        replay++;
+        row = 0;
+        return replay < static_cast<int>(warmup + repeat);
+    }
+
+    unsigned num_replays() const {
+        return warmup + repeat;
+    }
+
+    // Whether `custom_output` should be kept for the current replay
+    bool keeps_rows() const {
+        return replay == 0;
+    }
+
+    void record(DeltaResult &&result) {
+        if (replay == 0) {
+            rows.push_back(std::move(result));
+            times.emplace_back();
+            delta_times.emplace_back();
+        } else if (row >= rows.size() || (check_solutions && (rows[row].weight != result.weight ||
+                                                              rows[row].fingerprint != result.fingerprint))) {
+            if (mismatch.empty()) {
+                mismatch = result.algorithm + " (b = " + std::to_string(result.b) + ") at delta "
+                        + std::to_string(result.delta) + " in run " + std::to_string(replay + 1);
+            }
+            if (row >= rows.size()) {
+                return;
+            }
+        }
+        if (replay >= static_cast<int>(warmup)) {
+            times[row].push_back(result.time);
+            delta_times[row].push_back(result.delta_time);
+        }
+        row++;
+    }
+
+    // Description of the first row whose solution differed from the first replay, empty if there is none
+    const std::string& first_mismatch() const {
+        return mismatch;
+    }
+
+    const std::vector<DeltaResult>& get_rows() const {
+        return rows;
+    }
+
+    TimeSummary summarize(std::size_t index) const {
+        return summarize(times[index], delta_times[index]);
+    }
+
+    // Summarize the times of a single run
+    static TimeSummary summarize(double time, double delta_time) {
+        return {time, delta_time, time, time, time, 0};
+    }
+
+private:
+    // Two-sided 97.5% quantiles of Student's t-distribution for 1 to 30 degrees of freedom
+    static constexpr std::array<double, 30> t_quantiles = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+
+    static TimeSummary summarize(std::vector<double> sample, const std::vector<double> &delta_sample) {
+        const auto n = sample.size();
+        if (n == 0) {
+            return summarize(0, 0);
+        }
+        std::sort(sample.begin(), sample.end());
+        double mean = 0, mean_delta = 0;
+        for (std::size_t i = 0; i < n; i++) {
+            mean += sample[i];
+            mean_delta += delta_sample[i];
+        }
+        mean /= n;
+        mean_delta /= n;
+        double variance = 0;
+        for (auto value : sample) {
+            variance += (value - mean) * (value - mean);
+        }
+        double ci95 = 0;
+        if (n > 1) {
+            variance /= n - 1;
+            // Beyond 30 degrees of freedom, the normal distribution is a close enough approximation
+            double t = n - 1 <= t_quantiles.size() ? t_quantiles[n - 2] : 1.960;
+            ci95 = t * std::sqrt(variance / n);
+        }
+        double median = n % 2 ? sample[n / 2] : (sample[n / 2 - 1] + sample[n / 2]) / 2;
+        // Nearest-rank percentile
+        auto p95_rank = static_cast<std::size_t>(std::ceil(0.95 * n));
+        return {mean, mean_delta, sample.front(), median, sample[p95_rank - 1], ci95};
+    }
+
+    const unsigned warmup;
+    const unsigned repeat;
+    const bool check_solutions;
+    // Index of the current replay, starting at 0 with the first call of `next_replay`
+    int replay = -1;
+    std::size_t row = 0;
+    std::vector<DeltaResult> rows;
+    std::vector<std::vector<double>> times;
+    std::vector<std::vector<double>> delta_times;
+    std::string mismatch;
+};
@@ -0,0 +1,177 @@
+/**
+ * Copyright (C) 2022-2023 : Kathrin Hanauer, Lara Ost
+ *
+ * This file is part of DyDJ Match.
+ *
+ * DyDJ Match is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DyDJ Match is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DyDJ Match.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact information:
+ *   https://github.com/DJ-Match/DyDJ-Match
+ */
+
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <iomanip>
+#include <iostream>
+#include <ostream>
+#include <sstream>
+#include <string>
+
+#include "algorithm/disjoint_matching_algorithm.h"
+#include "io/demand_decay.h"
+#include "tools/chronotimer.h"
+#include "tools/datatable.h"
+#include "tools/repeated_runs.h"
+
+// Format specification for doubles
+template<>
+inline void format<double>(std::ostream &stream) {
+    stream << std::fixed << std::setprecision(6);
+}
+
+// Table for managing/printing the results
+using ResultTable = DataTable<false,
+                              TableEntry<3, int>,
+                              TableEntry<7, int>,
+                              TableEntry<25, std::string>,
+                              TableEntry<20, unsigned long>,
+                              TableEntry<12, double>,
+                              TableEntry<15, double>,
+                              TableEntry<15, double>,
+                              TableEntry<12, long>,
+                              TableEntry<14, long>,
+                              TableEntry<14, long>,
+                              TableEntry<12, long>,
+                              TableEntry<14, long>,
+                              TableEntry<14, long>,
+                              TableEntry<14, long>,
+                              TableEntry<14, long>,
+                              TableEntry<15, double>,
+                              TableEntry<17, double>,
+                              TableEntry<15, double>,
+                              TableEntry<15, double>>;
+
+inline const std::array<std::string, ResultTable::num_columns> result_columns = {"b",
+                                                                          "Delta",
+                                                                          "Algorithm",
+                                                                          "Weight",
+                                                                          "Time (s)",
+                                                                          "Delta-Time (s)",
+                                                                          "Total Time (s)",
+                                                                          "# color/up.",
+                                                                          "# uncolor/up.",
+                                                                          "# recolor/up.",
+                                                                          "# color/D",
+                                                                          "# uncolor/D",
+                                                                          "# recolor/D",
+                                                                          "# edges",
+                                                                          "size of delta",
+                                                                          "min Time (s)",
+                                                                          "median Time (s)",
+                                                                          "p95 Time (s)",
+                                                                          "CI95 Time (s)"};
+
+// Add the row for `result` to `table`, with `summary` summarizing its times.
+// Time columns report the mean over all repetitions.
+inline void add_result_row(ResultTable &table, const DeltaResult &result, const TimeSummary &summary) {
+    table.addRow(result.b,
+                result.delta,
+                result.algorithm,
+                result.weight,
+                summary.mean_time,
+                summary.mean_delta_time,
+                summary.mean_delta_time + summary.mean_time,
+                result.fine_counts.color_count,
+                result.fine_counts.uncolor_count,
+                result.fine_counts.recolor_count,
+                result.coarse_counts.color_count,
+                result.coarse_counts.uncolor_count,
+                result.coarse_counts.recolor_count,
+                result.num_arcs,
+                result.delta_size,
+                summary.min,
+                summary.median,
+                summary.p95,
+                summary.ci95);
+}
+
+// Run `algo` on the delta that has just been applied and add the results, followed by its custom output,
+// to `table`.
+// An algorithm with nested solutions adds a row for each of its nested numbers of matchings (see
+// `AlgorithmBase::set_nested_bs`), which share the time of the run and the counts of coloring operations,
+// followed by its custom output once.
+// With decaying demands, weights are scaled relative to an epoch and reported as decayed demands.
+// If `repetitions` is given, the results are recorded there instead, see `write_repeated_runs`.
+inline void run_delta(AlgorithmBase *algo, int b, int delta_counter, double deltaTime, DiGraph *graph,
+                      unsigned long delta_size, const DemandDecay *decay, ResultTable &table,
+                      RepeatedRuns *repetitions = nullptr) {
+    ChronoTimer timer;
+    algo->run();
+    auto time = timer.elapsed<>();
+    algo->post_run();
+
+    const auto &nested_bs = algo->get_nested_bs();
+    const std::size_t num_rows = std::max<std::size_t>(nested_bs.size(), 1);
+    for (std::size_t i = 0; i < num_rows; i++) {
+        const int row_b = nested_bs.empty() ? b : nested_bs[i];
+        const auto weight = nested_bs.empty() ? algo->deliver() : algo->deliver_nested(row_b);
+        DeltaResult result{row_b,
+                           delta_counter,
+                           algo->getName(),
+                           decay ? decay->decayed(weight) : weight,
+                           time,
+                           deltaTime,
+                           algo->get_fine_counts(),
+                           algo->get_coarse_counts(),
+                           static_cast<long>(graph->getNumArcs(false)),
+                           delta_size,
+                           0,
+                           {}};
+        if (!repetitions) {
+            add_result_row(table, result, RepeatedRuns::summarize(time, deltaTime));
+            continue;
+        }
+        if (repetitions->num_replays() > 1) {
+            result.fingerprint = algo->solution_fingerprint();
+        }
+        // The custom output follows the last row of the delta
+        if (repetitions->keeps_rows() && i + 1 == num_rows) {
+            std::ostringstream output;
+            algo->custom_output(output);
+            result.custom_output = output.str();
+        }
+        repetitions->record(std::move(result));
+    }
+    if (!repetitions) {
+        table.addOutput([algo](std::ostream &stream) { algo->custom_output(stream); });
+    }
+}
+
+// Write the rows collected in `repetitions` to `table`, summarizing their times.
+// Returns `false` if the repetitions did not compute the same solutions.
+inline bool write_repeated_runs(const RepeatedRuns &repetitions, ResultTable &table) {
+    const auto &rows = repetitions.get_rows();
+    for (std::size_t i = 0; i < rows.size(); i++) {
+        add_result_row(table, rows[i], repetitions.summarize(i));
+        table.addOutput([&rows, i](std::ostream &output) { output << rows[i].custom_output; });
+    }
+    if (!repetitions.first_mismatch().empty()) {
+        std::cerr << "Error! Solutions differ between runs of " << repetitions.first_mismatch() << std::endl;
+        return false;
+    }
+    return true;
+}
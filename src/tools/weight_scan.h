@@ -0,0 +1,96 @@
+/**
+ * Copyright (C) 2022-2023 : Kathrin Hanauer, Lara Ost
+ *
+ * This file is part of DyDJ Match.
+ *
+ * DyDJ Match is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * DyDJ Match is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with DyDJ Match.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contact information:
+ *   https://github.com/DJ-Match/DyDJ-Match
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+
+#ifdef __AVX2__
+    #include <immintrin.h>
+#endif
+
+#include "graph/arc.h"
+
+#include "algorithm/matching_defs.h"
+
+using namespace Algora;
+
+// First color `c` in `[begin, num_colors)` whose adjacent arcs weigh less than `weight`, see `first_lighter_color`.
+inline color_t first_lighter_color_scalar(const EdgeWeight *tail_weights,
+                                          const EdgeWeight *head_weights,
+                                          Arc* const *tail_arcs,
+                                          Arc* const *head_arcs,
+                                          color_t begin,
+                                          color_t num_colors,
+                                          EdgeWeight weight) {
+    for (color_t c = begin; c < num_colors; c++) {
+        auto sum = tail_weights[c] + (tail_arcs[c] == head_arcs[c] ? 0 : head_weights[c]);
+        if (sum < weight) {
+            return c;
+        }
+    }
+    return UNCOLORED;
+}
+
+// First color `c < num_colors` whose arcs `tail_arcs[c]` and `head_arcs[c]` adjacent to an arc weigh less
+// than `weight` in total, or `UNCOLORED` if there is none.
+// `tail_weights` and `head_weights` hold the weights of these arcs by color, 0 for missing arcs;
+// an arc adjacent at both ends (i.e., antiparallel to the arc) counts once.
+// Four colors are compared at a time with AVX2, if available; debug builds check the result
+// against `first_lighter_color_scalar`.
+inline color_t first_lighter_color(const EdgeWeight *tail_weights,
+                                   const EdgeWeight *head_weights,
+                                   Arc* const *tail_arcs,
+                                   Arc* const *head_arcs,
+                                   color_t num_colors,
+                                   EdgeWeight weight) {
+#ifdef __AVX2__
+    static_assert(sizeof(EdgeWeight) == 8 && sizeof(Arc*) == 8, "expecting 64-bit weights and pointers");
+    // AVX2 only compares signed 64-bit integers, so flip the sign bits of both sides
+    const auto sign = _mm256_set1_epi64x(std::int64_t{1} << 63);
+    const auto limit = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<std::int64_t>(weight)), sign);
+    color_t c = 0;
+    color_t result = UNCOLORED;
+    for (; c + 4 <= num_colors; c += 4) {
+        auto tw = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tail_weights + c));
+        auto hw = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(head_weights + c));
+        auto same = _mm256_cmpeq_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(tail_arcs + c)),
+                                       _mm256_loadu_si256(reinterpret_cast<const __m256i*>(head_arcs + c)));
+        auto sum = _mm256_add_epi64(tw, _mm256_andnot_si256(same, hw));
+        auto lighter = _mm256_cmpgt_epi64(limit, _mm256_xor_si256(sum, sign));
+        auto mask = _mm256_movemask_pd(_mm256_castsi256_pd(lighter));
+        if (mask != 0) {
+            result = c + __builtin_ctz(mask);
+            break;
+        }
+    }
+    if (result == UNCOLORED) {
+        result = first_lighter_color_scalar(tail_weights, head_weights, tail_arcs, head_arcs, c, num_colors, weight);
+    }
+    assert(result == first_lighter_color_scalar(tail_weights, head_weights, tail_arcs, head_arcs,
+                                                0, num_colors, weight));
+    return result;
+#else
+    return first_lighter_color_scalar(tail_weights, head_weights, tail_arcs, head_arcs, 0, num_colors, weight);
+#endif
+}